@@ -0,0 +1,238 @@
+// Times G-code output for a synthetic nest: formatting every line with
+// std::to_string into a vector of strings, as generateGCode used to, against
+// GCodeWriter into the controller's line vector, one string and a sink that
+// only counts. Reports moves written per second, the lines and bytes that
+// come out and the heap allocations made per move.
+//
+// Build with -DNANOCUT_BUILD_BENCHMARKS=ON and run
+//   bin/<type>/gcode_bench [parts] [repeats]
+
+#include <NcCamView/GCodeWriter/GCodeWriter.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <numbers>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<size_t> allocations{ 0 };
+
+struct Point {
+  double x;
+  double y;
+};
+
+// One torch-on run: pierce at the first point, cut through the rest
+struct Cut {
+  std::vector<Point> points;
+  double             feed;
+};
+
+// A grid of rounded plates, each with four bolt holes, flattened the way
+// offsets come out of the toolpath builder
+std::vector<Cut> makeJob(int parts)
+{
+  constexpr double size = 80.0;
+  constexpr double radius = 6.0;
+  constexpr double hole = 4.0;
+  constexpr int    segments = 72;
+  std::vector<Cut> job;
+  const int        columns = static_cast<int>(std::ceil(std::sqrt(parts)));
+  for (int p = 0; p < parts; p++) {
+    const double ox = (p % columns) * (size + 10.0) + 0.123456;
+    const double oy = (p / columns) * (size + 10.0) + 0.654321;
+    for (int h = 0; h < 4; h++) {
+      const double cx = ox + (h % 2 ? size - 15.0 : 15.0);
+      const double cy = oy + (h / 2 ? size - 15.0 : 15.0);
+      Cut          cut{ {}, 1500.0 * 0.6 };
+      for (int k = 0; k <= segments; k++) {
+        const double a = 2.0 * std::numbers::pi * k / segments;
+        cut.points.push_back(
+          { cx + hole * std::cos(a), cy + hole * std::sin(a) });
+      }
+      job.push_back(std::move(cut));
+    }
+    Cut outline{ {}, 1500.0 };
+    for (int corner = 0; corner < 4; corner++) {
+      const double cx = ox + (corner == 1 || corner == 2 ? size - radius
+                                                         : radius);
+      const double cy = oy + (corner >= 2 ? size - radius : radius);
+      for (int k = 0; k <= segments / 4; k++) {
+        const double a =
+          std::numbers::pi * (1.0 + 0.5 * corner) +
+          0.5 * std::numbers::pi * k / (segments / 4);
+        outline.points.push_back(
+          { cx + radius * std::cos(a), cy + radius * std::sin(a) });
+      }
+    }
+    outline.points.push_back(outline.points.front());
+    job.push_back(std::move(outline));
+  }
+  return job;
+}
+
+// The former emitter: one std::string per line, six decimals, every word
+std::vector<std::string> emitStrings(const std::vector<Cut>& job)
+{
+  std::vector<std::string> lines;
+  for (const Cut& cut : job) {
+    lines.push_back("G0 X" + std::to_string(-cut.points[0].x) + " Y" +
+                    std::to_string(-cut.points[0].y));
+    lines.push_back("fire_torch " + std::to_string(1.5) + " " +
+                    std::to_string(0.5) + " " + std::to_string(1.0) + " " +
+                    std::to_string(0.0));
+    for (const Point& pt : cut.points) {
+      lines.push_back("G1 X" + std::to_string(-pt.x) + " Y" +
+                      std::to_string(-pt.y) + " F" +
+                      std::to_string(cut.feed));
+    }
+    lines.push_back("torch_off");
+  }
+  lines.push_back("M30");
+  return lines;
+}
+
+void emitWriter(const std::vector<Cut>& job, GCodeWriter::Sink& sink)
+{
+  GCodeWriter gcode(sink);
+  for (const Cut& cut : job) {
+    gcode.rapid(-cut.points[0].x, -cut.points[0].y);
+    gcode.command("fire_torch", { 1.5, 0.5, 1.0, 0.0 });
+    for (const Point& pt : cut.points)
+      gcode.linear(-pt.x, -pt.y, cut.feed);
+    gcode.command("torch_off");
+  }
+  gcode.command("M30");
+}
+
+class CountingSink : public GCodeWriter::Sink {
+public:
+  void write(std::string_view chunk) override
+  {
+    bytes += chunk.size();
+    lines += std::count(chunk.begin(), chunk.end(), '\n');
+  }
+  size_t bytes = 0;
+  size_t lines = 0;
+};
+
+struct Result {
+  double seconds = 1e300;
+  size_t lines = 0;
+  size_t bytes = 0;
+  size_t allocations = 0;
+};
+
+// Best of `repeats` runs of `run`, which returns lines and bytes written
+template <typename Run> Result measure(int repeats, Run run)
+{
+  Result best;
+  for (int r = 0; r < repeats; r++) {
+    const size_t before = allocations.load();
+    const auto   start = std::chrono::steady_clock::now();
+    const auto [lines, bytes] = run();
+    const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    if (elapsed.count() < best.seconds) {
+      best.seconds = elapsed.count();
+      best.lines = lines;
+      best.bytes = bytes;
+      best.allocations = allocations.load() - before;
+    }
+  }
+  return best;
+}
+
+void report(const char* name, const Result& result, size_t moves)
+{
+  std::printf("%-14s %12.0f %9zu %10zu %9.2f\n",
+              name,
+              moves / result.seconds,
+              result.lines,
+              result.bytes,
+              static_cast<double>(result.allocations) / moves);
+}
+
+} // namespace
+
+void* operator new(size_t size)
+{
+  allocations++;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main(int argc, char** argv)
+{
+  const int parts = argc > 1 ? std::max(1, std::atoi(argv[1])) : 500;
+  const int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+  const std::vector<Cut> job = makeJob(parts);
+  size_t                 moves = 1;
+  for (const Cut& cut : job)
+    moves += cut.points.size() + 3;
+  std::printf("%d parts, %zu toolpaths, %zu moves and commands\n\n",
+              parts,
+              job.size(),
+              moves);
+  std::printf("%-14s %12s %9s %10s %9s\n",
+              "emitter",
+              "moves/s",
+              "lines",
+              "bytes",
+              "allocs/mv");
+
+  report("to_string",
+         measure(repeats,
+                 [&] {
+                   std::vector<std::string> lines = emitStrings(job);
+                   size_t                   bytes = 0;
+                   for (const auto& line : lines)
+                     bytes += line.size() + 1;
+                   return std::pair(lines.size(), bytes);
+                 }),
+         moves);
+  report("writer/lines",
+         measure(repeats,
+                 [&] {
+                   std::vector<std::string> lines;
+                   GCodeWriter::LineSink    sink(lines);
+                   emitWriter(job, sink);
+                   size_t bytes = 0;
+                   for (const auto& line : lines)
+                     bytes += line.size() + 1;
+                   return std::pair(lines.size(), bytes);
+                 }),
+         moves);
+  report("writer/string",
+         measure(repeats,
+                 [&] {
+                   std::string             text;
+                   GCodeWriter::StringSink sink(text);
+                   emitWriter(job, sink);
+                   return std::pair(static_cast<size_t>(std::count(
+                                      text.begin(), text.end(), '\n')),
+                                    text.size());
+                 }),
+         moves);
+  report("writer/count",
+         measure(repeats,
+                 [&] {
+                   CountingSink sink;
+                   emitWriter(job, sink);
+                   return std::pair(sink.lines, sink.bytes);
+                 }),
+         moves);
+  return 0;
+}
@@ -0,0 +1,577 @@
+// Nests a corpus of DXF / SVG parts headlessly and prints the run statistics
+// as one JSON object per job, so nesting speed and quality can be compared
+// across builds on a real job archive.
+//
+// A job spec lists the parts (paths relative to the spec) and the material:
+//
+//   {
+//     "sheet": [1200, 600],   // Material width and height in mm
+//     "sheets": 1,            // Optional: sheets to overflow onto
+//     "spacing": 50,          // Optional: gap between sheets in mm
+//     "seed": 42,             // Optional: optimizer seed
+//     "iterations": 2000,     // Optional: annealing iterations / GA budget
+//     "threads": 1,           // Optional: 0 = all cores
+//     "nfp": "exact",         // Optional: "exact" or "hull"
+//     "evaluator": "exact",   // Optional: "exact" or "raster"
+//     "optimizer": "annealing", // Optional: "annealing" or "genetic"
+//     "parts": [
+//       { "file": "bracket.dxf", "quantity": 6, "rotation": "free" },
+//       { "file": "panel.svg", "quantity": 2, "rotation": "flip",
+//         "scale": 25.4 }
+//     ]
+//   }
+//
+// Without "parts" one of every .dxf and .svg file next to the spec is nested.
+// Each file is one part: its largest closed contour is the outline and the
+// contours inside it are holes. Lines, arcs, circles, ellipses and (bulged)
+// polylines are read from DXF; splines and block inserts are skipped. Runs
+// are reproducible for a fixed seed with one thread.
+//
+// Build with -DNANOCUT_BUILD_BENCHMARKS=ON and run
+//   bin/<type>/nest_bench bench/corpus/job.json [more jobs ...]
+
+#include <NcCamView/PolyNest/PolyNest.h>
+
+#include <dxflib/dl_creationadapter.h>
+#include <dxflib/dl_dxf.h>
+#define NANOSVG_IMPLEMENTATION
+#include <nanosvg/nanosvg.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Contour = std::vector<PolyNest::PolyPoint>;
+
+namespace {
+
+// Chord tolerance of curve flattening and gap allowed when chaining
+// entities, in mm
+constexpr double kTolerance = 0.05;
+constexpr double kChainTolerance = 0.01;
+
+// An open or closed run of points read from a file
+struct Piece {
+  Contour points;
+  bool    closed = false;
+};
+
+int arcSegments(double radius, double sweep_rad)
+{
+  if (radius <= kTolerance)
+    return 2;
+  double step = 2.0 * std::acos(1.0 - kTolerance / radius);
+  return std::clamp(
+    static_cast<int>(std::ceil(std::fabs(sweep_rad) / step)), 2, 4096);
+}
+
+// Arc from `start_rad` sweeping `sweep_rad` (CCW if positive)
+Contour arcPoints(double cx,
+                  double cy,
+                  double r,
+                  double start_rad,
+                  double sweep_rad)
+{
+  int     n = arcSegments(r, sweep_rad);
+  Contour points;
+  for (int i = 0; i <= n; i++) {
+    double a = start_rad + sweep_rad * i / n;
+    points.emplace_back(cx + r * std::cos(a), cy + r * std::sin(a));
+  }
+  return points;
+}
+
+bool samePoint(const PolyNest::PolyPoint& a, const PolyNest::PolyPoint& b)
+{
+  return std::hypot(a.x - b.x, a.y - b.y) < kChainTolerance;
+}
+
+// ---------- DXF ----------
+
+class DxfReader : public DL_CreationAdapter {
+public:
+  std::vector<Piece> pieces;
+  int                skipped = 0; // Splines, which the reader can't flatten
+
+  // Block definitions only show up through inserts, which aren't expanded
+  void addBlock(const DL_BlockData&) override { m_in_block = true; }
+  void endBlock() override { m_in_block = false; }
+
+  void addLine(const DL_LineData& d) override
+  {
+    if (m_in_block)
+      return;
+    pieces.push_back({ { { d.x1, d.y1 }, { d.x2, d.y2 } } });
+  }
+  void addArc(const DL_ArcData& d) override
+  {
+    if (m_in_block)
+      return;
+    double sweep = d.angle2 - d.angle1;
+    if (sweep <= 0)
+      sweep += 360.0;
+    pieces.push_back({ arcPoints(d.cx,
+                                 d.cy,
+                                 d.radius,
+                                 d.angle1 * M_PI / 180.0,
+                                 sweep * M_PI / 180.0) });
+  }
+  void addCircle(const DL_CircleData& d) override
+  {
+    if (m_in_block)
+      return;
+    Piece circle{ arcPoints(d.cx, d.cy, d.radius, 0, 2 * M_PI), true };
+    circle.points.pop_back();
+    pieces.push_back(std::move(circle));
+  }
+  void addEllipse(const DL_EllipseData& d) override
+  {
+    if (m_in_block)
+      return;
+    double sweep = d.angle2 - d.angle1;
+    if (sweep <= 0)
+      sweep += 2 * M_PI;
+    double major = std::hypot(d.mx, d.my);
+    int    n = arcSegments(major, sweep);
+    Piece  ellipse;
+    ellipse.closed = std::fabs(sweep - 2 * M_PI) < 1e-6;
+    for (int i = 0; i <= (ellipse.closed ? n - 1 : n); i++) {
+      double t = d.angle1 + sweep * i / n;
+      double c = std::cos(t), s = std::sin(t) * d.ratio;
+      ellipse.points.emplace_back(d.cx + d.mx * c - d.my * s,
+                                  d.cy + d.my * c + d.mx * s);
+    }
+    pieces.push_back(std::move(ellipse));
+  }
+  void addPolyline(const DL_PolylineData& d) override
+  {
+    endPolyline();
+    m_in_polyline = !m_in_block;
+    m_polyline_closed = d.flags & 0x1;
+  }
+  void addVertex(const DL_VertexData& d) override
+  {
+    if (m_in_polyline)
+      m_vertices.push_back(d);
+  }
+  void addSpline(const DL_SplineData&) override { skipped += !m_in_block; }
+  // The vertices of a polyline arrive one by one until dxflib ends it
+  void endEntity() override { endPolyline(); }
+  void endSequence() override { endPolyline(); }
+
+  void endPolyline()
+  {
+    if (!m_in_polyline)
+      return;
+    m_in_polyline = false;
+    Piece  piece;
+    size_t n = m_vertices.size();
+    for (size_t i = 0; i < n; i++) {
+      const DL_VertexData& v = m_vertices[i];
+      piece.points.emplace_back(v.x, v.y);
+      if (i + 1 == n && !m_polyline_closed)
+        break;
+      const DL_VertexData& w = m_vertices[(i + 1) % n];
+      if (v.bulge == 0)
+        continue;
+      // The bulge is tan(sweep / 4); the centre lies left of the chord for
+      // sweeps under 180 degrees CCW
+      double sweep = 4 * std::atan(v.bulge);
+      double dx = w.x - v.x, dy = w.y - v.y;
+      double chord = std::hypot(dx, dy);
+      if (chord < kChainTolerance)
+        continue;
+      double d = 0.5 * chord / std::tan(0.5 * sweep);
+      double cx = 0.5 * (v.x + w.x) - dy / chord * d;
+      double cy = 0.5 * (v.y + w.y) + dx / chord * d;
+      Contour arc = arcPoints(cx,
+                              cy,
+                              std::hypot(v.x - cx, v.y - cy),
+                              std::atan2(v.y - cy, v.x - cx),
+                              sweep);
+      piece.points.insert(piece.points.end(), arc.begin() + 1, arc.end() - 1);
+    }
+    piece.closed = m_polyline_closed;
+    if (piece.points.size() > 1)
+      pieces.push_back(std::move(piece));
+    m_vertices.clear();
+  }
+
+private:
+  bool                       m_in_block = false;
+  bool                       m_in_polyline = false;
+  bool                       m_polyline_closed = false;
+  std::vector<DL_VertexData> m_vertices;
+};
+
+bool readDxf(const fs::path& path, std::vector<Piece>& pieces)
+{
+  DxfReader reader;
+  DL_Dxf    dxf;
+  if (!dxf.in(path.string(), &reader)) {
+    std::fprintf(stderr, "Failed to read %s\n", path.string().c_str());
+    return false;
+  }
+  reader.endPolyline();
+  if (reader.skipped > 0)
+    std::fprintf(stderr,
+                 "%s: skipped %d splines\n",
+                 path.string().c_str(),
+                 reader.skipped);
+  pieces = std::move(reader.pieces);
+  return true;
+}
+
+// ---------- SVG ----------
+
+void flattenCubic(Contour&                   out,
+                  const PolyNest::PolyPoint& p0,
+                  const PolyNest::PolyPoint& p1,
+                  const PolyNest::PolyPoint& p2,
+                  const PolyNest::PolyPoint& p3,
+                  int                        depth)
+{
+  // Flat once both control points lie within the tolerance of the chord
+  double dx = p3.x - p0.x, dy = p3.y - p0.y;
+  double d1 = std::fabs((p1.x - p3.x) * dy - (p1.y - p3.y) * dx);
+  double d2 = std::fabs((p2.x - p3.x) * dy - (p2.y - p3.y) * dx);
+  if (depth >= 16 ||
+      (d1 + d2) * (d1 + d2) <= kTolerance * kTolerance * (dx * dx + dy * dy)) {
+    out.push_back(p3);
+    return;
+  }
+  auto mid = [](const PolyNest::PolyPoint& a, const PolyNest::PolyPoint& b) {
+    return PolyNest::PolyPoint((a.x + b.x) * 0.5, (a.y + b.y) * 0.5);
+  };
+  PolyNest::PolyPoint p01 = mid(p0, p1), p12 = mid(p1, p2), p23 = mid(p2, p3);
+  PolyNest::PolyPoint p012 = mid(p01, p12), p123 = mid(p12, p23);
+  PolyNest::PolyPoint centre = mid(p012, p123);
+  flattenCubic(out, p0, p01, p012, centre, depth + 1);
+  flattenCubic(out, centre, p123, p23, p3, depth + 1);
+}
+
+bool readSvg(const fs::path& path, std::vector<Piece>& pieces)
+{
+  // Same units as the SVG importer; Y flipped to point up
+  NSVGimage* image = nsvgParseFromFile(path.string().c_str(), "mm", 96.0f);
+  if (!image) {
+    std::fprintf(stderr, "Failed to read %s\n", path.string().c_str());
+    return false;
+  }
+  auto toMm = [](const float* p) {
+    return PolyNest::PolyPoint(p[0], -static_cast<double>(p[1]));
+  };
+  for (NSVGshape* shape = image->shapes; shape; shape = shape->next) {
+    if (!(shape->flags & NSVG_FLAGS_VISIBLE))
+      continue;
+    for (NSVGpath* p = shape->paths; p; p = p->next) {
+      if (p->npts < 1)
+        continue;
+      Piece piece;
+      piece.points.push_back(toMm(p->pts));
+      for (int i = 0; i + 3 < p->npts; i += 3) {
+        const float* c = &p->pts[i * 2];
+        flattenCubic(piece.points,
+                     toMm(c),
+                     toMm(c + 2),
+                     toMm(c + 4),
+                     toMm(c + 6),
+                     0);
+      }
+      piece.closed = p->closed;
+      if (piece.points.size() > 1)
+        pieces.push_back(std::move(piece));
+    }
+  }
+  nsvgDelete(image);
+  return true;
+}
+
+// ---------- Parts ----------
+
+double signedArea(const Contour& c)
+{
+  double a = 0;
+  for (size_t i = 0, j = c.size() - 1; i < c.size(); j = i++)
+    a += c[j].x * c[i].y - c[i].x * c[j].y;
+  return a * 0.5;
+}
+
+bool insideContour(const PolyNest::PolyPoint& p, const Contour& c)
+{
+  bool inside = false;
+  for (size_t i = 0, j = c.size() - 1; i < c.size(); j = i++) {
+    if ((c[i].y > p.y) != (c[j].y > p.y) &&
+        p.x < c[j].x + (p.y - c[j].y) / (c[i].y - c[j].y) * (c[i].x - c[j].x))
+      inside = !inside;
+  }
+  return inside;
+}
+
+// Joins open pieces end to end into closed contours; returns how many
+// chains stayed open
+int chainPieces(std::vector<Piece>& pieces, std::vector<Contour>& contours)
+{
+  std::vector<Piece> open;
+  for (auto& piece : pieces) {
+    if (!piece.closed && samePoint(piece.points.front(), piece.points.back()))
+      piece.closed = true;
+    if (piece.closed) {
+      if (samePoint(piece.points.front(), piece.points.back()))
+        piece.points.pop_back();
+      if (piece.points.size() > 2)
+        contours.push_back(std::move(piece.points));
+    }
+    else {
+      open.push_back(std::move(piece));
+    }
+  }
+
+  int               unclosed = 0;
+  std::vector<bool> used(open.size(), false);
+  for (size_t i = 0; i < open.size(); i++) {
+    if (used[i])
+      continue;
+    used[i] = true;
+    Contour chain = open[i].points;
+    for (bool extended = true; extended;) {
+      extended = false;
+      for (size_t j = 0; j < open.size(); j++) {
+        if (used[j])
+          continue;
+        const Contour& next = open[j].points;
+        if (samePoint(chain.back(), next.front())) {
+          chain.insert(chain.end(), next.begin() + 1, next.end());
+        }
+        else if (samePoint(chain.back(), next.back())) {
+          chain.insert(chain.end(), next.rbegin() + 1, next.rend());
+        }
+        else {
+          continue;
+        }
+        used[j] = extended = true;
+      }
+    }
+    if (chain.size() > 3 && samePoint(chain.front(), chain.back())) {
+      chain.pop_back();
+      contours.push_back(std::move(chain));
+    }
+    else {
+      unclosed++;
+    }
+  }
+  return unclosed;
+}
+
+struct BenchPart {
+  std::vector<Contour>   contours; // Outline first
+  double                 area = 0; // Material area, holes subtracted
+  PolyNest::RotationMode rotation = PolyNest::RotationMode::Free;
+  double                 offset_x = 0;
+  double                 offset_y = 0;
+  double                 angle = 0;
+  bool                   visible = false;
+};
+
+bool loadPart(const fs::path& path, double scale, BenchPart& part)
+{
+  std::vector<Piece> pieces;
+  std::string        ext = path.extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+  bool ok = ext == ".dxf" ? readDxf(path, pieces)
+            : ext == ".svg"
+              ? readSvg(path, pieces)
+              : (std::fprintf(stderr,
+                              "%s: not a DXF or SVG file\n",
+                              path.string().c_str()),
+                 false);
+  if (!ok)
+    return false;
+
+  std::vector<Contour> contours;
+  if (int unclosed = chainPieces(pieces, contours))
+    std::fprintf(stderr,
+                 "%s: dropped %d open chains\n",
+                 path.string().c_str(),
+                 unclosed);
+  if (contours.empty()) {
+    std::fprintf(stderr, "%s: no closed contours\n", path.string().c_str());
+    return false;
+  }
+  for (auto& contour : contours) {
+    for (auto& p : contour) {
+      p.x *= scale;
+      p.y *= scale;
+    }
+  }
+  std::sort(contours.begin(),
+            contours.end(),
+            [](const Contour& a, const Contour& b) {
+              return std::fabs(signedArea(a)) > std::fabs(signedArea(b));
+            });
+
+  // Holes alternate with islands by nesting depth
+  part.contours = { contours.front() };
+  part.area = std::fabs(signedArea(contours.front()));
+  for (size_t i = 1; i < contours.size(); i++) {
+    if (!insideContour(contours[i].front(), contours.front())) {
+      std::fprintf(stderr,
+                   "%s: contour outside the outline dropped\n",
+                   path.string().c_str());
+      continue;
+    }
+    int depth = 0;
+    for (size_t j = 1; j < i; j++)
+      depth += insideContour(contours[i].front(), contours[j]);
+    double area = std::fabs(signedArea(contours[i]));
+    part.area += depth % 2 ? area : -area;
+    part.contours.push_back(contours[i]);
+  }
+  return true;
+}
+
+PolyNest::RotationMode parseRotation(const std::string& name)
+{
+  if (name == "flip")
+    return PolyNest::RotationMode::Flip;
+  if (name == "fixed")
+    return PolyNest::RotationMode::Fixed;
+  return PolyNest::RotationMode::Free;
+}
+
+// ---------- Jobs ----------
+
+bool runJob(const fs::path& spec_path, nlohmann::json& report)
+{
+  std::ifstream  file(spec_path);
+  nlohmann::json spec =
+    nlohmann::json::parse(file, nullptr, /*allow_exceptions=*/false);
+  if (spec.is_discarded() || !spec.contains("sheet")) {
+    std::fprintf(stderr,
+                 "%s: not a job spec (needs \"sheet\")\n",
+                 spec_path.string().c_str());
+    return false;
+  }
+  const fs::path dir = spec_path.parent_path();
+  const double   sheet_w = spec["sheet"].at(0).get<double>();
+  const double   sheet_h = spec["sheet"].at(1).get<double>();
+
+  nlohmann::json entries = spec.value("parts", nlohmann::json::array());
+  if (entries.empty()) {
+    std::vector<std::string> files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+      std::string ext = entry.path().extension().string();
+      std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+      if (ext == ".dxf" || ext == ".svg")
+        files.push_back(entry.path().filename().string());
+    }
+    std::sort(files.begin(), files.end()); // Directory order isn't stable
+    for (const auto& name : files)
+      entries.push_back({ { "file", name } });
+  }
+
+  // Parts are pushed by pointer, so the list must not reallocate afterwards
+  std::vector<BenchPart> parts;
+  for (const auto& entry : entries) {
+    BenchPart part;
+    if (!loadPart(dir / entry.at("file").get<std::string>(),
+                  entry.value("scale", 1.0),
+                  part))
+      return false;
+    part.rotation = parseRotation(entry.value("rotation", "free"));
+    int quantity = entry.value("quantity", 1);
+    for (int i = 0; i < quantity; i++)
+      parts.push_back(part);
+  }
+
+  PolyNest::PolyNest nest;
+  nest.setExtents(PolyNest::PolyPoint(0, 0),
+                  PolyNest::PolyPoint(sheet_w, sheet_h));
+  nest.setSheets(spec.value("sheets", 1), spec.value("spacing", 0.0));
+  nest.setSeed(spec.value("seed", 42u));
+  nest.setAnnealingIterations(spec.value("iterations", 2000));
+  nest.setThreadCount(spec.value("threads", 1u));
+  nest.setNfpMode(spec.value("nfp", "exact") == "hull"
+                    ? PolyNest::NfpMode::Hull
+                    : PolyNest::NfpMode::Exact);
+  nest.setEvaluator(spec.value("evaluator", "exact") == "raster"
+                      ? PolyNest::NestEvaluator::Raster
+                      : PolyNest::NestEvaluator::Exact);
+  nest.setOptimizer(spec.value("optimizer", "annealing") == "genetic"
+                      ? PolyNest::NestOptimizer::Genetic
+                      : PolyNest::NestOptimizer::Annealing);
+  for (auto& part : parts) {
+    nest.pushUnplacedPolyPart(part.contours,
+                              &part.offset_x,
+                              &part.offset_y,
+                              &part.angle,
+                              &part.visible,
+                              part.rotation);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  nest.beginPlaceUnplacedPolyParts();
+  nest.placeAllUnplacedParts(nullptr);
+  double time_ms = std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  // The nest publishes its layout rather than writing it to the parts
+  uint64_t layout_version = 0;
+  nest.applyBestLayout(layout_version);
+
+  // Every sheet before the last is used in full, the last up to the
+  // bounding width
+  const PolyNest::NestStats& stats = nest.getStats();
+  double                     placed_area = 0;
+  for (const auto& part : parts) {
+    if (part.visible)
+      placed_area += part.area;
+  }
+  double used_area =
+    (std::max(stats.sheets_used, 1) - 1) * sheet_w * sheet_h +
+    stats.bounding_width * sheet_h;
+  size_t lookups = stats.nfp_cache_hits + stats.nfp_cache_misses;
+
+  report = { { "job", spec_path.string() },
+             { "parts", parts.size() },
+             { "parts_placed", stats.parts_placed },
+             { "sheets_used", stats.sheets_used },
+             { "bounding_width", stats.bounding_width },
+             { "utilization", used_area > 0 ? placed_area / used_area : 0.0 },
+             { "time_ms", time_ms },
+             { "blf_calls", stats.blf_calls },
+             { "nfp_computed", stats.nfp_computed },
+             { "nfp_time_ms", stats.nfp_time_ms },
+             { "nfp_cache_hits", stats.nfp_cache_hits },
+             { "nfp_cache_misses", stats.nfp_cache_misses },
+             { "nfp_hit_rate",
+               lookups > 0 ? double(stats.nfp_cache_hits) / lookups : 0.0 },
+             { "compaction_moves", stats.compaction_moves } };
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::fprintf(stderr, "Usage: %s <job.json> [job.json ...]\n", argv[0]);
+    return 2;
+  }
+  int failed = 0;
+  for (int i = 1; i < argc; i++) {
+    nlohmann::json report;
+    if (runJob(argv[i], report))
+      std::printf("%s\n", report.dump().c_str());
+    else
+      failed++;
+  }
+  return failed > 0 ? 1 : 0;
+}
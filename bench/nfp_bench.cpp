@@ -0,0 +1,414 @@
+// Compares the convex-hull and exact (convex decomposition) NFP modes of
+// PolyNest on bracket-heavy jobs: sheet utilization, used length and the time
+// spent building NFPs. Jobs with holes also run without part-in-part, and
+// every job once more with the raster evaluator and with the genetic
+// optimizer.
+//
+// On the long sheet every mode places every part, so the used length is all
+// that differs. A second table nests each job on small sheets, where
+// interlocking decides how many parts fit a sheet: it reports the parts that
+// fit a single sheet and the sheets needed for the whole job.
+//
+// Build with -DNANOCUT_BUILD_BENCHMARKS=ON and run
+//   bin/<type>/nfp_bench [iterations] [threads] [job]
+
+#include <NcCamView/PolyNest/PolyNest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using Contour = std::vector<PolyNest::PolyPoint>;
+
+namespace {
+
+struct BenchPart {
+  std::vector<Contour> contours;
+  double               area;
+  double               offset_x = 0;
+  double               offset_y = 0;
+  double               angle = 0;
+  bool                 visible = false;
+};
+
+double contourArea(const Contour& c)
+{
+  double a = 0;
+  for (size_t i = 0; i < c.size(); i++) {
+    const auto& p = c[i];
+    const auto& q = c[(i + 1) % c.size()];
+    a += p.x * q.y - q.x * p.y;
+  }
+  return std::fabs(a) * 0.5;
+}
+
+BenchPart makePart(Contour outline, std::vector<Contour> holes = {})
+{
+  BenchPart part;
+  part.area = contourArea(outline);
+  part.contours.push_back(std::move(outline));
+  for (auto& hole : holes) {
+    part.area -= contourArea(hole);
+    part.contours.push_back(std::move(hole));
+  }
+  return part;
+}
+
+Contour rect(double x, double y, double w, double h)
+{
+  return { { x, y }, { x + w, y }, { x + w, y + h }, { x, y + h } };
+}
+
+// Frame: w x h with two side-by-side windows inside a border of width b
+BenchPart frame(double w, double h, double b)
+{
+  double win_w = (w - 3 * b) * 0.5;
+  return makePart(rect(0, 0, w, h),
+                  { rect(b, b, win_w, h - 2 * b),
+                    rect(2 * b + win_w, b, win_w, h - 2 * b) });
+}
+
+// Right-angled gusset with legs of length l
+BenchPart gusset(double l)
+{
+  return makePart({ { 0, 0 }, { l, 0 }, { 0, l } });
+}
+
+// L-bracket: w x h with legs of thickness t
+BenchPart lBracket(double w, double h, double t)
+{
+  return makePart({ { 0, 0 }, { w, 0 }, { w, t }, { t, t }, { t, h }, { 0, h } });
+}
+
+// C-channel: w x h, opening to the right, wall thickness t
+BenchPart cChannel(double w, double h, double t)
+{
+  return makePart({ { 0, 0 },
+                    { w, 0 },
+                    { w, t },
+                    { t, t },
+                    { t, h - t },
+                    { w, h - t },
+                    { w, h },
+                    { 0, h } });
+}
+
+// T-flange: flange of width w and thickness t over a web of height h
+BenchPart tFlange(double w, double h, double t)
+{
+  double l = (w - t) * 0.5;
+  return makePart({ { l, 0 },
+                    { l + t, 0 },
+                    { l + t, h - t },
+                    { w, h - t },
+                    { w, h },
+                    { 0, h },
+                    { 0, h - t },
+                    { l, h - t } });
+}
+
+struct Job {
+  const char*            name;
+  std::vector<BenchPart> parts;
+  bool                   has_holes = false;
+};
+
+std::vector<Job> makeJobs()
+{
+  std::vector<Job> jobs;
+
+  Job brackets{ "brackets", {} };
+  for (int i = 0; i < 16; i++)
+    brackets.parts.push_back(lBracket(160, 120, 30));
+  jobs.push_back(std::move(brackets));
+
+  Job channels{ "channels", {} };
+  for (int i = 0; i < 10; i++)
+    channels.parts.push_back(cChannel(140, 180, 30));
+  jobs.push_back(std::move(channels));
+
+  Job mixed{ "mixed", {} };
+  for (int i = 0; i < 8; i++) {
+    mixed.parts.push_back(lBracket(160, 120, 30));
+    mixed.parts.push_back(cChannel(140, 180, 30));
+    mixed.parts.push_back(tFlange(150, 110, 25));
+  }
+  jobs.push_back(std::move(mixed));
+
+  // Many copies of one shape: deduplication keeps this close to the cost of a
+  // single-bracket job
+  Job bulk{ "bulk", {} };
+  for (int i = 0; i < 50; i++)
+    bulk.parts.push_back(lBracket(80, 60, 15));
+  jobs.push_back(std::move(bulk));
+
+  // Framed windows cut alongside small gussets and plates
+  Job frames{ "frames", {}, true };
+  for (int i = 0; i < 3; i++)
+    frames.parts.push_back(frame(380, 280, 30));
+  for (int i = 0; i < 10; i++) {
+    frames.parts.push_back(gusset(90));
+    frames.parts.push_back(makePart(rect(0, 0, 70, 45)));
+  }
+  jobs.push_back(std::move(frames));
+  return jobs;
+}
+
+// Contours of a part as placed by the nest (same rotation as PolyPart)
+ClipperLib::Paths placedOutline(const BenchPart& part)
+{
+  double            rad = (M_PI / 180.0) * part.angle;
+  double            c = std::cos(rad), s = std::sin(rad);
+  ClipperLib::Paths out;
+  for (const auto& contour : part.contours) {
+    ClipperLib::Path path;
+    for (const auto& p : contour)
+      path.push_back(ClipperLib::FPoint(c * p.x + s * p.y + part.offset_x,
+                                        c * p.y - s * p.x + part.offset_y));
+    out.push_back(std::move(path));
+  }
+  return out;
+}
+
+// Number of placed part pairs whose material overlaps (should always be
+// zero); holes are subtracted by the even-odd fill
+int countOverlaps(const std::vector<ClipperLib::Paths>& outlines)
+{
+  int overlaps = 0;
+  for (size_t i = 0; i < outlines.size(); i++) {
+    for (size_t j = i + 1; j < outlines.size(); j++) {
+      ClipperLib::Clipper c;
+      c.AddPaths(outlines[i], ClipperLib::ptSubject, true);
+      c.AddPaths(outlines[j], ClipperLib::ptClip, true);
+      ClipperLib::Paths common;
+      c.Execute(ClipperLib::ctIntersection,
+                common,
+                ClipperLib::pftEvenOdd,
+                ClipperLib::pftEvenOdd);
+      double area = 0;
+      for (const auto& path : common)
+        area += std::fabs(ClipperLib::Area(path));
+      if (area > 1.0)
+        overlaps++;
+    }
+  }
+  return overlaps;
+}
+
+struct Result {
+  int    placed;
+  int    overlaps;
+  double width;
+  double utilization;
+  double nfp_ms;
+  size_t nfp_count;
+  double total_ms;
+  int    sheets_used;
+  double placed_area;
+};
+
+// Material the job is nested on: `max_sheets` sheets of w x h
+struct Sheet {
+  double w;
+  double h;
+  int    max_sheets;
+};
+
+// The long sheet every mode fits each job on
+constexpr Sheet kLongSheet = { 1200, 600, 1 };
+// The small sheet of the fixed-sheet table; the jobs need several of them
+constexpr double kSmallSheetW = 400;
+constexpr double kSmallSheetH = 300;
+constexpr int    kSmallSheetMax = 16;
+
+Result runJob(Job                     job,
+              PolyNest::NfpMode       mode,
+              PolyNest::NestEvaluator evaluator,
+              PolyNest::NestOptimizer optimizer,
+              bool                    part_in_part,
+              int                     iterations,
+              int                     threads,
+              const Sheet&            sheet = kLongSheet)
+{
+  PolyNest::PolyNest nest;
+  nest.setExtents(PolyNest::PolyPoint(0, 0),
+                  PolyNest::PolyPoint(sheet.w, sheet.h));
+  nest.setSheets(sheet.max_sheets, 20);
+  nest.setNfpMode(mode);
+  nest.setEvaluator(evaluator);
+  nest.setOptimizer(optimizer);
+  nest.setPartInPart(part_in_part);
+  nest.setAnnealingIterations(iterations);
+  nest.setThreadCount(threads);
+
+  // Parts start left of the sheet; the ones that fit nowhere go back there
+  double part_area = 0;
+  for (auto& part : job.parts) {
+    part.offset_x = -2 * sheet.w;
+    nest.pushUnplacedPolyPart(part.contours,
+                              &part.offset_x,
+                              &part.offset_y,
+                              &part.angle,
+                              &part.visible);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  nest.beginPlaceUnplacedPolyParts();
+  nest.placeAllUnplacedParts(nullptr);
+  double total_ms = std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  // The nest publishes its layout rather than writing it to the parts
+  uint64_t layout_version = 0;
+  nest.applyBestLayout(layout_version);
+
+  // Utilization is measured against the bounding box of the placed parts
+  std::vector<ClipperLib::Paths> outlines;
+  double                         max_x = 0, max_y = 0;
+  for (const auto& part : job.parts) {
+    if (!part.visible || part.offset_x < 0)
+      continue;
+    part_area += part.area;
+    outlines.push_back(placedOutline(part));
+    for (const auto& pt : outlines.back().front()) {
+      max_x = std::max(max_x, pt.X);
+      max_y = std::max(max_y, pt.Y);
+    }
+  }
+
+  const PolyNest::NestStats& stats = nest.getStats();
+  double                     used = max_x * max_y;
+  // Counted from the parts, as the stats only cover the last sheet
+  return { static_cast<int>(outlines.size()),
+           countOverlaps(outlines),
+           stats.bounding_width,
+           used > 0 ? part_area / used : 0.0,
+           stats.nfp_time_ms,
+           stats.nfp_computed,
+           total_ms,
+           stats.sheets_used,
+           part_area };
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  int iterations = argc > 1 ? std::stoi(argv[1]) : 500;
+  int threads = argc > 2 ? std::stoi(argv[2]) : 0; // 0 = all cores
+  std::string only = argc > 3 ? argv[3] : "";
+
+  std::printf("%-10s %-6s %7s %8s %9s %8s %8s %10s %10s\n",
+              "job",
+              "mode",
+              "placed",
+              "overlaps",
+              "width",
+              "util",
+              "nfps",
+              "nfp_ms",
+              "total_ms");
+  using PolyNest::NestEvaluator;
+  using PolyNest::NestOptimizer;
+  using PolyNest::NfpMode;
+  struct Config {
+    const char*   name;
+    NfpMode       mode;
+    NestEvaluator evaluator;
+    NestOptimizer optimizer;
+    bool          part_in_part;
+  };
+  const Config configs[] = {
+    { "hull", NfpMode::Hull, NestEvaluator::Exact, NestOptimizer::Annealing,
+      true },
+    { "exact", NfpMode::Exact, NestEvaluator::Exact, NestOptimizer::Annealing,
+      true },
+    { "no-pip", NfpMode::Exact, NestEvaluator::Exact,
+      NestOptimizer::Annealing, false },
+    { "raster", NfpMode::Exact, NestEvaluator::Raster,
+      NestOptimizer::Annealing, true },
+    { "ga", NfpMode::Exact, NestEvaluator::Exact, NestOptimizer::Genetic,
+      true }
+  };
+  for (const Job& job : makeJobs()) {
+    if (!only.empty() && only != job.name)
+      continue;
+    for (const Config& config : configs) {
+      if (!config.part_in_part && !job.has_holes)
+        continue;
+      Result r = runJob(job,
+                        config.mode,
+                        config.evaluator,
+                        config.optimizer,
+                        config.part_in_part,
+                        iterations,
+                        threads);
+      std::printf("%-10s %-6s %3d/%-3zu %8d %9.1f %7.1f%% %8zu %10.1f %10.1f\n",
+                  job.name,
+                  config.name,
+                  r.placed,
+                  job.parts.size(),
+                  r.overlaps,
+                  r.width,
+                  r.utilization * 100.0,
+                  r.nfp_count,
+                  r.nfp_ms,
+                  r.total_ms);
+    }
+  }
+
+  // Small sheets: parts that fit one sheet, and sheets needed for the job.
+  // Fill is the part area over the area of the sheets used.
+  std::printf("\n%-10s %-6s %7s %8s %7s %7s %7s\n",
+              "job",
+              "mode",
+              "1-sheet",
+              "overlaps",
+              "fill",
+              "sheets",
+              "fill");
+  const Sheet one_sheet = { kSmallSheetW, kSmallSheetH, 1 };
+  const Sheet all_sheets = { kSmallSheetW, kSmallSheetH, kSmallSheetMax };
+  const double sheet_area = kSmallSheetW * kSmallSheetH;
+  for (const Job& job : makeJobs()) {
+    if (!only.empty() && only != job.name)
+      continue;
+    for (const Config& config : configs) {
+      // Hull against exact only
+      if (config.evaluator != NestEvaluator::Exact ||
+          config.optimizer != NestOptimizer::Annealing || !config.part_in_part)
+        continue;
+      Result one = runJob(job,
+                          config.mode,
+                          config.evaluator,
+                          config.optimizer,
+                          config.part_in_part,
+                          iterations,
+                          threads,
+                          one_sheet);
+      Result all = runJob(job,
+                          config.mode,
+                          config.evaluator,
+                          config.optimizer,
+                          config.part_in_part,
+                          iterations,
+                          threads,
+                          all_sheets);
+      double all_area = all.sheets_used * sheet_area;
+      std::printf("%-10s %-6s %3d/%-3zu %8d %6.1f%% %3d%s %6.1f%%\n",
+                  job.name,
+                  config.name,
+                  one.placed,
+                  job.parts.size(),
+                  one.overlaps + all.overlaps,
+                  one.placed_area / sheet_area * 100.0,
+                  all.sheets_used,
+                  all.placed < static_cast<int>(job.parts.size()) ? "+" : " ",
+                  all_area > 0 ? all.placed_area / all_area * 100.0 : 0.0);
+    }
+  }
+  return 0;
+}
@@ -151,6 +151,11 @@ void NcApp::shutdown()
     m_control_view->close();
   }
 
+  // Finish any background CAM work and persist the NFP cache
+  if (m_cam_view) {
+    m_cam_view->close();
+  }
+
   if (m_renderer) {
     logUptime();
     m_renderer->close();
@@ -0,0 +1,660 @@
+#include "CutSequencer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <string_view>
+
+namespace CutSequencer {
+
+namespace {
+
+constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+// Candidate moves tried per tour position, and improvement passes at most
+constexpr size_t neighbours = 8;
+constexpr int    max_passes = 25;
+// Runs an EntryCache entry outlives its last use
+constexpr uint64_t cache_runs = 8;
+
+double distance(const Point2d& a, const Point2d& b)
+{
+  return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+// Static 2-d tree over a fixed set of points, any of which can be switched
+// off and back on; queries only see the points that are on. Node [lo, hi)
+// of the implicit layout sits at (lo + hi) / 2 and splits on x at even
+// depths, on y at odd ones.
+class PointTree {
+public:
+  explicit PointTree(const std::vector<Point2d>& points)
+    : m_nodes(points.size()), m_slot(points.size())
+  {
+    for (size_t i = 0; i < points.size(); i++)
+      m_nodes[i] = { points[i], i, true, 0 };
+    build(0, m_nodes.size(), 0);
+    for (size_t i = 0; i < m_nodes.size(); i++)
+      m_slot[m_nodes[i].id] = i;
+  }
+
+  void setOn(size_t id, bool on)
+  {
+    const size_t slot = m_slot[id];
+    if (m_nodes[slot].on == on)
+      return;
+    m_nodes[slot].on = on;
+    size_t lo = 0, hi = m_nodes.size();
+    while (true) {
+      const size_t mid = (lo + hi) / 2;
+      m_nodes[mid].count += on ? 1 : -1;
+      if (mid == slot)
+        break;
+      if (slot < mid)
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+  }
+
+  // Nearest point that is on, or npos if none is
+  size_t nearest(const Point2d& p) const
+  {
+    std::vector<std::pair<double, size_t>> best;
+    search(0, m_nodes.size(), 0, p, 1, best);
+    return best.empty() ? npos : best.front().second;
+  }
+
+  // Up to `k` nearest points that are on, in no particular order
+  void nearest(const Point2d& p, size_t k, std::vector<size_t>& out) const
+  {
+    std::vector<std::pair<double, size_t>> best;
+    search(0, m_nodes.size(), 0, p, k, best);
+    out.clear();
+    for (const auto& [d2, id] : best)
+      out.push_back(id);
+  }
+
+private:
+  struct Node {
+    Point2d point;
+    size_t  id;
+    bool    on;
+    size_t  count; // Points on in the subtree, this one included
+  };
+  std::vector<Node>   m_nodes;
+  std::vector<size_t> m_slot; // Node of each point id
+
+  size_t build(size_t lo, size_t hi, int depth)
+  {
+    if (lo >= hi)
+      return 0;
+    const size_t mid = (lo + hi) / 2;
+    std::nth_element(m_nodes.begin() + lo,
+                     m_nodes.begin() + mid,
+                     m_nodes.begin() + hi,
+                     [depth](const Node& a, const Node& b) {
+                       return depth % 2 ? a.point.y < b.point.y
+                                        : a.point.x < b.point.x;
+                     });
+    m_nodes[mid].count =
+      1 + build(lo, mid, depth + 1) + build(mid + 1, hi, depth + 1);
+    return m_nodes[mid].count;
+  }
+
+  // `best` is a max-heap on squared distance holding up to `k` points
+  void search(size_t                                  lo,
+              size_t                                  hi,
+              int                                     depth,
+              const Point2d&                          p,
+              size_t                                  k,
+              std::vector<std::pair<double, size_t>>& best) const
+  {
+    if (lo >= hi)
+      return;
+    const size_t mid = (lo + hi) / 2;
+    const Node&  node = m_nodes[mid];
+    if (node.count == 0)
+      return;
+
+    if (node.on) {
+      const double dx = p.x - node.point.x;
+      const double dy = p.y - node.point.y;
+      const double d2 = dx * dx + dy * dy;
+      if (best.size() < k) {
+        best.emplace_back(d2, node.id);
+        std::push_heap(best.begin(), best.end());
+      }
+      else if (d2 < best.front().first) {
+        std::pop_heap(best.begin(), best.end());
+        best.back() = { d2, node.id };
+        std::push_heap(best.begin(), best.end());
+      }
+    }
+
+    const double diff =
+      depth % 2 ? p.y - node.point.y : p.x - node.point.x;
+    const bool near_left = diff < 0;
+    if (near_left)
+      search(lo, mid, depth + 1, p, k, best);
+    else
+      search(mid + 1, hi, depth + 1, p, k, best);
+    if (best.size() < k || diff * diff < best.front().first) {
+      if (near_left)
+        search(mid + 1, hi, depth + 1, p, k, best);
+      else
+        search(lo, mid, depth + 1, p, k, best);
+    }
+  }
+};
+
+// The innermost closed toolpath each toolpath lies in, or npos. It is the
+// one that has to be cut right after it; the containment chain takes care of
+// the ones further out.
+std::vector<size_t> findParents(const std::vector<Part::Toolpath>& toolpaths)
+{
+  const size_t              n = toolpaths.size();
+  std::vector<geo::Extents> bboxes(n);
+  std::vector<double>       areas(n);
+  std::vector<size_t>       closed;
+  for (size_t i = 0; i < n; i++) {
+    bboxes[i] = geo::calculateBoundingBox(toolpaths[i].points);
+    areas[i] = (bboxes[i].max.x - bboxes[i].min.x) *
+               (bboxes[i].max.y - bboxes[i].min.y);
+    if (toolpaths[i].is_closed_contour)
+      closed.push_back(i);
+  }
+  // By left edge, so the scan for containers can stop early
+  std::sort(closed.begin(), closed.end(), [&](size_t a, size_t b) {
+    return bboxes[a].min.x < bboxes[b].min.x;
+  });
+
+  std::vector<size_t> parents(n, npos);
+  for (size_t i = 0; i < n; i++) {
+    const auto& pts = toolpaths[i].points;
+    // Probe with the contour start: a lead-in may reach outside the container
+    const Point2d probe =
+      pts[std::min(toolpaths[i].lead_in_count, pts.size() - 1)];
+    for (size_t c : closed) {
+      if (bboxes[c].min.x > bboxes[i].min.x)
+        break;
+      // A container is strictly bigger, which also keeps two identical
+      // contours from each waiting on the other
+      if (areas[c] <= areas[i] ||
+          (parents[i] != npos && areas[c] >= areas[parents[i]]))
+        continue;
+      if (!geo::extentsContain(bboxes[c], bboxes[i]))
+        continue;
+      if (geo::pointIsInsidePolygon(toolpaths[c].points, probe))
+        parents[i] = c;
+    }
+  }
+  return parents;
+}
+
+// Greedy walk to the nearest pierce among the toolpaths whose contents are
+// all cut already
+std::vector<size_t> nearestNeighbour(const std::vector<Point2d>& entries,
+                                     const std::vector<Point2d>& exits,
+                                     const std::vector<size_t>&  parents,
+                                     Point2d                     start)
+{
+  const size_t        n = entries.size();
+  std::vector<size_t> pending(n, 0); // Contents not cut yet
+  for (size_t parent : parents) {
+    if (parent != npos)
+      pending[parent]++;
+  }
+  PointTree ready(entries);
+  for (size_t i = 0; i < n; i++) {
+    if (pending[i])
+      ready.setOn(i, false);
+  }
+
+  std::vector<size_t> order;
+  order.reserve(n);
+  Point2d at = start;
+  while (order.size() < n) {
+    // Containers are strictly bigger than their contents, so something is
+    // always ready
+    const size_t next = ready.nearest(at);
+    if (next == npos)
+      break;
+    order.push_back(next);
+    ready.setOn(next, false);
+    at = exits[next];
+    if (parents[next] != npos && --pending[parents[next]] == 0)
+      ready.setOn(parents[next], true);
+  }
+  return order;
+}
+
+// 2-opt and Or-opt over a tour of directed toolpaths: each is entered at its
+// pierce and left at its end, so the rapids of a reversed stretch run the
+// other way and are summed separately. Moves are only tried towards the
+// nearest few pierces / ends, and only kept if no toolpath ends up after
+// its container.
+class Improver {
+public:
+  Improver(const std::vector<Point2d>& entries,
+           const std::vector<Point2d>& exits,
+           const std::vector<size_t>&  parents,
+           Point2d                     start,
+           std::vector<size_t>&        order)
+    : m_entries(entries), m_exits(exits), m_parents(parents), m_start(start),
+      m_order(order), m_n(order.size()), m_pos(m_n), m_forward(m_n),
+      m_backward(m_n)
+  {
+    refresh();
+  }
+
+  void run()
+  {
+    PointTree           entry_tree(m_entries);
+    PointTree           exit_tree(m_exits);
+    std::vector<size_t> near;
+    for (int pass = 0; pass < max_passes; pass++) {
+      bool improved = false;
+
+      // 2-opt: rapid from the toolpath before `a` straight to `b`, cutting
+      // a..b in reverse
+      for (size_t a = 0; a < m_n; a++) {
+        entry_tree.nearest(exitAt(a - 1), neighbours, near);
+        for (size_t id : near) {
+          const size_t b = m_pos[id];
+          if (b > a && twoOpt(a, b)) {
+            improved = true;
+            break;
+          }
+        }
+      }
+
+      // Or-opt: move up to three toolpaths in a row to right after the one
+      // whose end is nearest their first pierce
+      for (size_t length = 1; length <= 3; length++) {
+        for (size_t s = 0; s + length <= m_n; s++) {
+          exit_tree.nearest(m_entries[m_order[s]], neighbours, near);
+          for (size_t id : near) {
+            if (orOpt(s, s + length - 1, m_pos[id])) {
+              improved = true;
+              break;
+            }
+          }
+        }
+      }
+
+      if (!improved)
+        break;
+    }
+  }
+
+private:
+  static constexpr double epsilon = 1e-9;
+
+  const std::vector<Point2d>& m_entries;
+  const std::vector<Point2d>& m_exits;
+  const std::vector<size_t>&  m_parents;
+  Point2d                     m_start;
+  std::vector<size_t>&        m_order;
+  size_t                      m_n;
+  std::vector<size_t>         m_pos; // Tour position of each toolpath
+  // Prefix sums of the rapids k -> k + 1 and k + 1 -> k over the tour
+  std::vector<double>         m_forward;
+  std::vector<double>         m_backward;
+
+  // End of the toolpath at tour position `k`, the start for k == npos
+  const Point2d& exitAt(size_t k) const
+  {
+    return k == npos ? m_start : m_exits[m_order[k]];
+  }
+  const Point2d& entryAt(size_t k) const { return m_entries[m_order[k]]; }
+  double         rapid(size_t from, size_t to) const
+  {
+    return to < m_n ? distance(exitAt(from), entryAt(to)) : 0.0;
+  }
+  // Tour position of the container of the toolpath at `k`, or npos
+  size_t parentAt(size_t k) const
+  {
+    const size_t parent = m_parents[m_order[k]];
+    return parent == npos ? npos : m_pos[parent];
+  }
+
+  void refresh()
+  {
+    for (size_t k = 0; k < m_n; k++)
+      m_pos[m_order[k]] = k;
+    for (size_t k = 0; k + 1 < m_n; k++) {
+      m_forward[k + 1] = m_forward[k] + rapid(k, k + 1);
+      m_backward[k + 1] = m_backward[k] +
+                          distance(exitAt(k + 1), entryAt(k));
+    }
+  }
+
+  bool twoOpt(size_t a, size_t b)
+  {
+    const double delta =
+      distance(exitAt(a - 1), entryAt(b)) - rapid(a - 1, a) +
+      (m_backward[b] - m_backward[a]) - (m_forward[b] - m_forward[a]) +
+      rapid(a, b + 1) - rapid(b, b + 1);
+    if (delta > -epsilon)
+      return false;
+    // Reversing keeps the stretch's place but not the order inside it
+    for (size_t k = a; k <= b; k++) {
+      const size_t parent = parentAt(k);
+      if (parent != npos && parent >= a && parent <= b)
+        return false;
+    }
+    std::reverse(m_order.begin() + a, m_order.begin() + b + 1);
+    refresh();
+    return true;
+  }
+
+  // Moves s..e to right after position `c`
+  bool orOpt(size_t s, size_t e, size_t c)
+  {
+    if (c + 1 >= s && c <= e)
+      return false;
+    const double removed =
+      rapid(s - 1, s) + rapid(e, e + 1) -
+      (e + 1 < m_n ? distance(exitAt(s - 1), entryAt(e + 1)) : 0.0);
+    const double added = distance(exitAt(c), entryAt(s)) + rapid(e, c + 1) -
+                         rapid(c, c + 1);
+    if (added - removed > -epsilon)
+      return false;
+    if (c > e) {
+      // Moving later: nothing skipped over may be a container of the stretch
+      for (size_t k = s; k <= e; k++) {
+        const size_t parent = parentAt(k);
+        if (parent != npos && parent > e && parent <= c)
+          return false;
+      }
+      std::rotate(m_order.begin() + s,
+                  m_order.begin() + e + 1,
+                  m_order.begin() + c + 1);
+    }
+    else {
+      // Moving earlier: nothing skipped over may lie inside the stretch
+      for (size_t k = c + 1; k < s; k++) {
+        const size_t parent = parentAt(k);
+        if (parent != npos && parent >= s && parent <= e)
+          return false;
+      }
+      std::rotate(m_order.begin() + c + 1,
+                  m_order.begin() + s,
+                  m_order.begin() + e + 1);
+    }
+    refresh();
+    return true;
+  }
+};
+
+// Moves the entry of each closed toolpath, in tour order, towards where the
+// one before it ends. Keeps a move only if it shortens the rapids in and out
+// of the toolpath. Returns how many moved.
+size_t moveEntries(std::vector<Part::Toolpath>& toolpaths,
+                   const std::vector<size_t>&   order,
+                   std::vector<Point2d>&        entries,
+                   std::vector<Point2d>&        exits,
+                   Point2d                      start,
+                   EntryCache*                  cache)
+{
+  size_t         moved = 0;
+  Point2d        at = start;
+  Part::Toolpath moved_tp;
+  for (size_t k = 0; k < order.size(); k++) {
+    const size_t i = order[k];
+    // Rapids in from `at` and out to the next pierce
+    auto rapids = [&](const Point2d& entry, const Point2d& exit) {
+      return distance(at, entry) +
+             (k + 1 < order.size() ? distance(exit, entries[order[k + 1]])
+                                   : 0.0);
+    };
+    const bool led = cache
+                       ? cache->moveEntry(toolpaths[i], at, &moved_tp)
+                       : Part::moveToolpathEntry(toolpaths[i], at, &moved_tp);
+    if (led &&
+        rapids(moved_tp.points.front(), moved_tp.points.back()) <
+          rapids(entries[i], exits[i]) - 1e-9) {
+      toolpaths[i] = std::move(moved_tp);
+      entries[i] = toolpaths[i].points.front();
+      exits[i] = toolpaths[i].points.back();
+      moved++;
+    }
+    at = exits[i];
+  }
+  return moved;
+}
+
+double rapidDistance(const std::vector<Part::Toolpath>& toolpaths,
+                     Point2d                            start)
+{
+  double  total = 0.0;
+  Point2d at = start;
+  for (const auto& tp : toolpaths) {
+    total += distance(at, tp.points.front());
+    at = tp.points.back();
+  }
+  return total;
+}
+
+// Tours `toolpaths` from `start` and reorders them to match. Returns where
+// the last one ends.
+Point2d tour(std::vector<Part::Toolpath>& toolpaths,
+             Point2d                      start,
+             EntryCache*                  cache,
+             Stats&                       stats)
+{
+  const size_t n = toolpaths.size();
+  if (n == 0)
+    return start;
+
+  std::vector<Point2d> entries(n);
+  std::vector<Point2d> exits(n);
+  for (size_t i = 0; i < n; i++) {
+    entries[i] = toolpaths[i].points.front();
+    exits[i] = toolpaths[i].points.back();
+  }
+
+  const std::vector<size_t> parents = findParents(toolpaths);
+  std::vector<size_t>       order =
+    nearestNeighbour(entries, exits, parents, start);
+  Improver(entries, exits, parents, start, order).run();
+  // Moving entries changes the best tour, which in turn changes the best
+  // entries; two rounds get nearly all of it
+  for (int round = 0; round < 2; round++) {
+    const size_t moved =
+      moveEntries(toolpaths, order, entries, exits, start, cache);
+    stats.entries_moved += moved;
+    if (moved == 0)
+      break;
+    Improver(entries, exits, parents, start, order).run();
+  }
+
+  std::vector<Part::Toolpath> sequenced;
+  sequenced.reserve(n);
+  for (size_t i : order)
+    sequenced.push_back(std::move(toolpaths[i]));
+  toolpaths = std::move(sequenced);
+  return toolpaths.back().points.back();
+}
+
+// Whether segments a-b and c-d cross, other than within `epsilon` of a or b
+bool segmentsCross(const Point2d& a,
+                   const Point2d& b,
+                   const Point2d& c,
+                   const Point2d& d,
+                   double         epsilon)
+{
+  const double rx = b.x - a.x, ry = b.y - a.y;
+  const double sx = d.x - c.x, sy = d.y - c.y;
+  const double denom = rx * sy - ry * sx;
+  if (std::fabs(denom) < 1e-12)
+    return false;
+  const double t = ((c.x - a.x) * sy - (c.y - a.y) * sx) / denom;
+  const double u = ((c.x - a.x) * ry - (c.y - a.y) * rx) / denom;
+  const double margin = epsilon / std::hypot(rx, ry);
+  return t > margin && t < 1.0 - margin && u >= 0.0 && u <= 1.0;
+}
+
+// Whether a and b would get the same leads at the same hint
+bool sameToolpath(const Part::Toolpath& a, const Part::Toolpath& b)
+{
+  return a.points.size() == b.points.size() &&
+         a.lead_in_count == b.lead_in_count &&
+         a.lead_out_count == b.lead_out_count &&
+         a.is_closed_contour == b.is_closed_contour &&
+         a.is_inside_contour == b.is_inside_contour &&
+         a.lead_in_length == b.lead_in_length &&
+         a.lead_out_length == b.lead_out_length &&
+         a.smoothing == b.smoothing && a.kerf_width == b.kerf_width &&
+         std::memcmp(a.points.data(),
+                     b.points.data(),
+                     a.points.size() * sizeof(Point2d)) == 0;
+}
+
+} // namespace
+
+bool EntryCache::moveEntry(const Part::Toolpath& tp,
+                           Point2d               entry_hint,
+                           Part::Toolpath*       out)
+{
+  const std::string_view points(reinterpret_cast<const char*>(tp.points.data()),
+                                tp.points.size() * sizeof(Point2d));
+  const size_t hash = std::hash<std::string_view>{}(points) ^
+                      std::hash<double>{}(entry_hint.x) * 31 ^
+                      std::hash<double>{}(entry_hint.y);
+  auto [it, end] = m_entries.equal_range(hash);
+  for (; it != end; ++it) {
+    Entry& entry = it->second;
+    if (entry.entry_hint.x == entry_hint.x &&
+        entry.entry_hint.y == entry_hint.y && sameToolpath(entry.from, tp)) {
+      entry.run = m_run;
+      if (entry.moved) {
+        *out = entry.to;
+        out->tag = tp.tag;
+      }
+      return entry.moved;
+    }
+  }
+  Entry entry{ tp, entry_hint, false, {}, m_run };
+  entry.moved = Part::moveToolpathEntry(tp, entry_hint, &entry.to);
+  if (entry.moved)
+    *out = entry.to;
+  const bool moved = entry.moved;
+  m_entries.emplace(hash, std::move(entry));
+  return moved;
+}
+
+void EntryCache::nextRun()
+{
+  m_run++;
+  std::erase_if(m_entries, [&](const auto& entry) {
+    return entry.second.run + cache_runs <= m_run;
+  });
+}
+
+Stats sequence(std::vector<Part::Toolpath>& toolpaths,
+               Point2d                      start,
+               bool                         outlines_last,
+               EntryCache*                  cache)
+{
+  if (cache)
+    cache->nextRun();
+  std::erase_if(toolpaths,
+                [](const Part::Toolpath& tp) { return tp.points.empty(); });
+
+  Stats stats;
+  stats.toolpaths = toolpaths.size();
+  stats.rapid_before = rapidDistance(toolpaths, start);
+  if (!outlines_last) {
+    tour(toolpaths, start, cache, stats);
+  }
+  else {
+    // Outlines nothing else contains go last, everything else (holes, and
+    // parts nested in holes with theirs) first
+    const std::vector<size_t>   parents = findParents(toolpaths);
+    std::vector<Part::Toolpath> inner;
+    std::vector<Part::Toolpath> outlines;
+    for (size_t i = 0; i < toolpaths.size(); i++) {
+      const bool outline = toolpaths[i].is_closed_contour &&
+                           !toolpaths[i].is_inside_contour &&
+                           parents[i] == npos;
+      (outline ? outlines : inner).push_back(std::move(toolpaths[i]));
+    }
+    tour(outlines, tour(inner, start, cache, stats), cache, stats);
+    toolpaths = std::move(inner);
+    for (auto& tp : outlines)
+      toolpaths.push_back(std::move(tp));
+  }
+  stats.rapid_after = rapidDistance(toolpaths, start);
+  return stats;
+}
+
+std::vector<bool> findBridges(const std::vector<Part::Toolpath>& toolpaths,
+                              double max_bridge_length,
+                              double min_part_size)
+{
+  const size_t n = toolpaths.size();
+  // The contours proper, leads left out: a bridge may run over the scrap a
+  // lead pierces into, never through a part
+  std::vector<std::vector<Point2d>> contours(n);
+  std::vector<geo::Extents>         bboxes(n);
+  for (size_t i = 0; i < n; i++) {
+    const Part::Toolpath& tp = toolpaths[i];
+    if (tp.points.size() < tp.lead_in_count + tp.lead_out_count + 2)
+      continue;
+    // Up to the closing vertex, the first one counted as lead-out
+    const size_t end =
+      tp.points.size() - tp.lead_out_count + (tp.lead_out_count ? 1 : 0);
+    contours[i].assign(tp.points.begin() + tp.lead_in_count,
+                       tp.points.begin() + end);
+    bboxes[i] = geo::calculateBoundingBox(contours[i]);
+  }
+
+  auto chainable = [&](size_t i) {
+    const geo::Extents& bbox = bboxes[i];
+    return toolpaths[i].is_closed_contour &&
+           !toolpaths[i].is_inside_contour && !contours[i].empty() &&
+           std::min(bbox.max.x - bbox.min.x, bbox.max.y - bbox.min.y) >=
+             min_part_size;
+  };
+  // Slack for the bridge ends, which may sit right on a contour when there
+  // is no lead
+  constexpr double epsilon = 1e-6;
+  auto clear = [&](const Point2d& from, const Point2d& to) {
+    const Point2d      mid = { (from.x + to.x) / 2, (from.y + to.y) / 2 };
+    const geo::Extents span = { { std::min(from.x, to.x),
+                                  std::min(from.y, to.y) },
+                                { std::max(from.x, to.x),
+                                  std::max(from.y, to.y) } };
+    for (size_t i = 0; i < n; i++) {
+      const auto& contour = contours[i];
+      if (contour.empty() || bboxes[i].max.x < span.min.x ||
+          bboxes[i].min.x > span.max.x || bboxes[i].max.y < span.min.y ||
+          bboxes[i].min.y > span.max.y)
+        continue;
+      for (size_t k = 0; k + 1 < contour.size(); k++) {
+        if (segmentsCross(from, to, contour[k], contour[k + 1], epsilon))
+          return false;
+      }
+      // Not crossing anything, a bridge may still run inside a part
+      if (toolpaths[i].is_closed_contour && !toolpaths[i].is_inside_contour &&
+          geo::pointIsInsidePolygon(contour, mid))
+        return false;
+    }
+    return true;
+  };
+
+  std::vector<bool> bridged(n, false);
+  for (size_t i = 1; i < n; i++) {
+    const Point2d& from = toolpaths[i - 1].points.back();
+    const Point2d& to = toolpaths[i].points.front();
+    bridged[i] = chainable(i - 1) && chainable(i) &&
+                 distance(from, to) <= max_bridge_length && clear(from, to);
+  }
+  return bridged;
+}
+
+} // namespace CutSequencer
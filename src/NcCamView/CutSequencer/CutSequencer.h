@@ -0,0 +1,74 @@
+#ifndef CUT_SEQUENCER_
+#define CUT_SEQUENCER_
+
+#include <NcRender/primitives/Part/Part.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Orders the toolpaths of a whole job, every part on the sheet at once, to
+// shorten the rapids between them. A toolpath lying inside a closed one is
+// always cut first, whichever parts they belong to: holes before their
+// outline, and a part nested in another's hole before that hole.
+namespace CutSequencer {
+
+struct Stats {
+  size_t toolpaths = 0;
+  double rapid_before = 0.0; // Rapid travel of the order given
+  double rapid_after = 0.0;
+  size_t entries_moved = 0; // Closed toolpaths re-led nearer the cut before
+};
+
+// Leads rebuilt by earlier runs of sequence(), by toolpath and entry hint.
+// Re-leading is most of the time sequencing takes, and after a small change
+// to a job most toolpaths get the same hints as before. Runs that pass the
+// same cache share it; what the last few have not used is dropped.
+class EntryCache {
+public:
+  // Part::moveToolpathEntry, or what it gave last time for the same `tp`
+  // and `entry_hint`
+  bool moveEntry(const Part::Toolpath& tp,
+                 Point2d               entry_hint,
+                 Part::Toolpath*       out);
+  // Starts a run, dropping entries the last few have not used
+  void nextRun();
+
+private:
+  struct Entry {
+    Part::Toolpath from;
+    Point2d        entry_hint;
+    bool           moved;
+    Part::Toolpath to;
+    uint64_t       run; // Last run to use it
+  };
+  std::unordered_multimap<size_t, Entry> m_entries;
+  uint64_t                               m_run = 0;
+};
+
+// Reorders `toolpaths`, given in the order they would be cut otherwise.
+// Rapids are measured from `start` to each pierce (the first point) and from
+// the end of each toolpath (its last point) to the next pierce. Empty
+// toolpaths are dropped. Closed toolpaths may get their leads rebuilt to
+// enter nearer where the previous cut ends. With `outlines_last`, every part
+// outline is cut after everything inside any of them, so that neighbouring
+// outlines follow each other for chain cutting. Leads are rebuilt through
+// `cache` if there is one.
+Stats sequence(std::vector<Part::Toolpath>& toolpaths,
+               Point2d                      start = { 0.0, 0.0 },
+               bool                         outlines_last = false,
+               EntryCache*                  cache = nullptr);
+
+// Chain cutting: marks each toolpath that can be reached from the one before
+// it by a straight bridge cut through the scrap, saving a pierce. Both have
+// to be outside contours at least `min_part_size` across, the bridge at most
+// `max_bridge_length` long, and it may not cross or run inside any contour
+// of `toolpaths`.
+std::vector<bool> findBridges(const std::vector<Part::Toolpath>& toolpaths,
+                              double max_bridge_length,
+                              double min_part_size);
+
+} // namespace CutSequencer
+
+#endif
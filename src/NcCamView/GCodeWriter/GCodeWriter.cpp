@@ -0,0 +1,169 @@
+#include "GCodeWriter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <ostream>
+
+namespace {
+
+// Characters buffered before they are handed to the sink
+constexpr size_t chunk_size = 64 * 1024;
+
+} // namespace
+
+void GCodeWriter::StreamSink::write(std::string_view chunk)
+{
+  m_stream.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+}
+
+void GCodeWriter::StringSink::write(std::string_view chunk)
+{
+  m_text.append(chunk);
+}
+
+void GCodeWriter::LineSink::write(std::string_view chunk)
+{
+  size_t begin = 0;
+  size_t end;
+  while ((end = chunk.find('\n', begin)) != std::string_view::npos) {
+    m_lines.emplace_back(chunk.substr(begin, end - begin));
+    begin = end + 1;
+  }
+}
+
+GCodeWriter::GCodeWriter(Sink& sink, int precision)
+  : m_sink(sink), m_precision(std::clamp(precision, 0, 12)),
+    m_buffer(chunk_size)
+{
+}
+
+GCodeWriter::~GCodeWriter() { flush(); }
+
+void GCodeWriter::rapid(double x, double y)
+{
+  reserve(max_line);
+  append("G0");
+  word('X', x, &m_x, true);
+  word('Y', y, &m_y, true);
+  endLine();
+}
+
+void GCodeWriter::linear(double x, double y, double feed)
+{
+  reserve(max_line);
+  const size_t start = m_size;
+  append("G1");
+  // Both axes are checked, so that both are remembered
+  const bool moved =
+    word('X', x, &m_x, false) | word('Y', y, &m_y, false);
+  if (!moved) {
+    m_size = start;
+    return;
+  }
+  word('F', feed, &m_feed, false);
+  endLine();
+}
+
+void GCodeWriter::arc(bool ccw, double x, double y, double i, double j,
+                      double feed)
+{
+  reserve(max_line);
+  append(ccw ? "G3" : "G2");
+  // An arc needs at least one axis word; with neither changed it is a full
+  // circle and gets both
+  const bool moved =
+    word('X', x, &m_x, false) | word('Y', y, &m_y, false);
+  if (!moved) {
+    word('X', x, &m_x, true);
+    word('Y', y, &m_y, true);
+  }
+  word('I', i, nullptr, true);
+  word('J', j, nullptr, true);
+  word('F', feed, &m_feed, false);
+  endLine();
+}
+
+void GCodeWriter::command(std::string_view               name,
+                          std::initializer_list<double> args)
+{
+  reserve(name.size() + args.size() * (max_number + 1) + 1);
+  append(name);
+  for (double arg : args) {
+    m_buffer[m_size++] = ' ';
+    m_size = number(&m_buffer[m_size], arg) - m_buffer.data();
+  }
+  endLine();
+  m_feed.size = 0;
+}
+
+void GCodeWriter::flush()
+{
+  if (m_size == 0)
+    return;
+  m_sink.write({ m_buffer.data(), m_size });
+  m_size = 0;
+}
+
+void GCodeWriter::reserve(size_t size)
+{
+  if (m_size + size <= m_buffer.size())
+    return;
+  flush();
+  if (size > m_buffer.size())
+    m_buffer.resize(size);
+}
+
+void GCodeWriter::append(std::string_view text)
+{
+  std::memcpy(&m_buffer[m_size], text.data(), text.size());
+  m_size += text.size();
+}
+
+bool GCodeWriter::word(char letter, double value, Word* last, bool force)
+{
+  char*       out = &m_buffer[m_size];
+  char* const digits = out + 2;
+  char* const end = number(digits, value);
+  const auto  size = static_cast<size_t>(end - digits);
+  if (last) {
+    if (!force && last->size == size &&
+        std::memcmp(last->text, digits, size) == 0)
+      return false;
+    std::memcpy(last->text, digits, size);
+    last->size = size;
+  }
+  out[0] = ' ';
+  out[1] = letter;
+  m_size = end - m_buffer.data();
+  return true;
+}
+
+void GCodeWriter::endLine()
+{
+  m_buffer[m_size++] = '\n';
+  m_lines++;
+}
+
+char* GCodeWriter::number(char* out, double value) const
+{
+  char* const limit = out + max_number;
+  auto [end, error] =
+    std::to_chars(out, limit, value, std::chars_format::fixed, m_precision);
+  if (error != std::errc()) {
+    // Too large for fixed notation; no coordinate ever is
+    return std::to_chars(out, limit, value).ptr;
+  }
+  if (std::find(out, end, '.') != end) {
+    while (end[-1] == '0')
+      end--;
+    if (end[-1] == '.')
+      end--;
+  }
+  // -0.0001 rounds to "-0"
+  if (end - out == 2 && out[0] == '-' && out[1] == '0') {
+    out[0] = '0';
+    end = out + 1;
+  }
+  return end;
+}
@@ -0,0 +1,110 @@
+#ifndef GCODE_WRITER_
+#define GCODE_WRITER_
+
+#include <cstddef>
+#include <initializer_list>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Formats a program with std::to_chars into a fixed chunk buffer and hands
+// it on to a sink in whole lines, so writing a job allocates nothing per
+// line. Numbers go out with at most `precision` decimals and no trailing
+// zeros. Words that would not change the machine state are left out: the
+// feed while it stays the same, and an axis a move does not change. Rapids
+// always carry both axes, since a program can be started from any of them.
+class GCodeWriter {
+public:
+  // Receives the program a chunk at a time; chunks end on a line break
+  class Sink {
+  public:
+    virtual ~Sink() = default;
+    virtual void write(std::string_view chunk) = 0;
+  };
+
+  // Writes to a file or any other stream
+  class StreamSink : public Sink {
+  public:
+    explicit StreamSink(std::ostream& stream) : m_stream(stream) {}
+    void write(std::string_view chunk) override;
+
+  private:
+    std::ostream& m_stream;
+  };
+
+  // Collects the program as one string
+  class StringSink : public Sink {
+  public:
+    explicit StringSink(std::string& text) : m_text(text) {}
+    void write(std::string_view chunk) override;
+
+  private:
+    std::string& m_text;
+  };
+
+  // Collects the program a line at a time, as the controller queues it
+  class LineSink : public Sink {
+  public:
+    explicit LineSink(std::vector<std::string>& lines) : m_lines(lines) {}
+    void write(std::string_view chunk) override;
+
+  private:
+    std::vector<std::string>& m_lines;
+  };
+
+  explicit GCodeWriter(Sink& sink, int precision = 3);
+  ~GCodeWriter(); // Flushes
+
+  GCodeWriter(const GCodeWriter&) = delete;
+  GCodeWriter& operator=(const GCodeWriter&) = delete;
+
+  // G0 to (x, y)
+  void rapid(double x, double y);
+  // G1 to (x, y); dropped if it goes nowhere
+  void linear(double x, double y, double feed);
+  // G2 (clockwise) or G3 to (x, y) about the centre offset (i, j) from the
+  // current position
+  void arc(bool ccw, double x, double y, double i, double j, double feed);
+  // Controller command such as fire_torch, followed by its arguments. The
+  // controller may issue moves of its own to carry it out, so the feed is
+  // written again on the next cut.
+  void command(std::string_view name, std::initializer_list<double> args = {});
+  // Hands everything written so far to the sink
+  void flush();
+
+  size_t lineCount() const { return m_lines; }
+
+private:
+  // Longest formatted number, sign and decimals included
+  static constexpr size_t max_number = 48;
+  // Longest line the writer produces, bar command names
+  static constexpr size_t max_line = 8 * max_number;
+
+  // Formatted value of a modal word; empty when unknown
+  struct Word {
+    char   text[max_number];
+    size_t size = 0;
+  };
+
+  // Makes room for `size` more characters
+  void reserve(size_t size);
+  void append(std::string_view text);
+  // Appends " <letter><value>" unless `force` is off and it matches `last`;
+  // returns whether it did
+  bool word(char letter, double value, Word* last, bool force);
+  void endLine();
+  // Formats `value` at `out`, returns the end
+  char* number(char* out, double value) const;
+
+  Sink&             m_sink;
+  int               m_precision;
+  std::vector<char> m_buffer;
+  size_t            m_size = 0;
+  size_t            m_lines = 0;
+  Word              m_x;
+  Word              m_y;
+  Word              m_feed;
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "Program.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+// Angle from `from` to `to` turning counter-clockwise, in [0, 2 pi)
+double ccwAngle(double from, double to)
+{
+  const double angle = std::fmod(to - from, 2.0 * std::numbers::pi);
+  return angle < 0.0 ? angle + 2.0 * std::numbers::pi : angle;
+}
+
+} // namespace
+
+void Program::rapid(Point2d to)
+{
+  steps.push_back({ Op::Rapid, currentCut() });
+  steps.back().to = to;
+  extend(to);
+}
+
+void Program::line(Point2d to, float feed)
+{
+  steps.push_back({ Op::Line, currentCut(), feed });
+  steps.back().to = to;
+  extend(to);
+}
+
+void Program::arc(Point2d to, Point2d center, bool ccw, float feed)
+{
+  const Point2d from = steps.empty() ? Point2d{ 0.0, 0.0 } : steps.back().to;
+  steps.push_back({ ccw ? Op::ArcCcw : Op::ArcCw,
+                    currentCut(),
+                    feed,
+                    to,
+                    { center.x - from.x, center.y - from.y } });
+  extend(to);
+
+  // The arc reaches past its ends wherever it crosses an axis through the
+  // centre
+  const double radius = std::hypot(from.x - center.x, from.y - center.y);
+  const double start = std::atan2(from.y - center.y, from.x - center.x);
+  const double end = std::atan2(to.y - center.y, to.x - center.x);
+  double       sweep = ccw ? ccwAngle(start, end) : ccwAngle(end, start);
+  if (sweep == 0.0)
+    sweep = 2.0 * std::numbers::pi; // Back where it started: a full circle
+  for (int quadrant = 0; quadrant < 4; quadrant++) {
+    const double axis = quadrant * std::numbers::pi / 2.0;
+    if ((ccw ? ccwAngle(start, axis) : ccwAngle(axis, start)) < sweep) {
+      extend({ center.x + radius * std::cos(axis),
+               center.y + radius * std::sin(axis) });
+    }
+  }
+}
+
+void Program::command(Op op)
+{
+  // Commands stay where the last move left off
+  Step step{ op, currentCut() };
+  if (!steps.empty())
+    step.to = steps.back().to;
+  steps.push_back(step);
+}
+
+void Program::write(GCodeWriter& writer, size_t first) const
+{
+  for (size_t s = first; s < steps.size(); s++) {
+    const Step& step = steps[s];
+    switch (step.op) {
+      case Op::Rapid:
+        writer.rapid(-step.to.x, -step.to.y);
+        break;
+      case Op::Line:
+        writer.linear(-step.to.x, -step.to.y, step.feed);
+        break;
+      case Op::ArcCw:
+      case Op::ArcCcw:
+        writer.arc(step.op == Op::ArcCcw,
+                   -step.to.x,
+                   -step.to.y,
+                   -step.center.x,
+                   -step.center.y,
+                   step.feed);
+        break;
+      case Op::FireTorch: {
+        const Cut& cut = cuts[step.cut];
+        writer.command(
+          "fire_torch",
+          { cut.pierce_height, cut.pierce_delay, cut.cut_height, cut.thc });
+        break;
+      }
+      case Op::TorchOff:
+        writer.command("torch_off");
+        break;
+      case Op::TorchOffAsync:
+        writer.command("torch_off_async");
+        break;
+      case Op::End:
+        writer.command("M30");
+        break;
+    }
+  }
+}
+
+uint32_t Program::currentCut() const
+{
+  return cuts.empty() ? 0 : static_cast<uint32_t>(cuts.size() - 1);
+}
+
+void Program::extend(Point2d p)
+{
+  bbox.min.x = std::min(bbox.min.x, p.x);
+  bbox.min.y = std::min(bbox.min.y, p.y);
+  bbox.max.x = std::max(bbox.max.x, p.x);
+  bbox.max.y = std::max(bbox.max.y, p.y);
+}
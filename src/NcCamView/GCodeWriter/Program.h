@@ -0,0 +1,71 @@
+#ifndef PROGRAM_
+#define PROGRAM_
+
+#include "GCodeWriter.h"
+
+#include <NcRender/geometry/geometry.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A cutting program as the CAM view generates it: one step per G-code line,
+// in table coordinates, with the cut and part each step belongs to. The
+// control view previews it and streams it as it is; it only becomes text on
+// its way to a file or the controller, through write().
+struct Program {
+  enum class Op : uint8_t {
+    Rapid,
+    Line,
+    ArcCw,
+    ArcCcw,
+    FireTorch,
+    TorchOff,
+    TorchOffAsync, // Torch off without waiting for motion to stop
+    End,
+  };
+  struct Step {
+    Op       op;
+    uint32_t cut = 0;    // Index into `cuts`
+    float    feed = 0.0f; // Lines and arcs
+    Point2d  to = { 0.0, 0.0 };
+    Point2d  center = { 0.0, 0.0 }; // Arcs: centre offset from the start
+  };
+  // One toolpath: pierced with these settings, or chained on from the one
+  // before without firing
+  struct Cut {
+    uint32_t part = 0; // Index into `parts`
+    float    pierce_height = 0.0f;
+    float    pierce_delay = 0.0f;
+    float    cut_height = 0.0f;
+    float    thc = 0.0f;
+  };
+
+  std::vector<Step>        steps;
+  std::vector<Cut>         cuts;
+  std::vector<std::string> parts; // Names of the parts cut
+  // Extents of every move, arcs included
+  geo::Extents             bbox = { Point2d::infPos(), Point2d::infNeg() };
+  // Decimals write() gives coordinates and feeds
+  int                      decimals = 3;
+
+  // Building, in cut order. Moves belong to the cut begun last.
+  void beginCut(const Cut& cut) { cuts.push_back(cut); }
+  void rapid(Point2d to);
+  void line(Point2d to, float feed);
+  // Arc from the current position to `to` about `center`
+  void arc(Point2d to, Point2d center, bool ccw, float feed);
+  void command(Op op);
+
+  // Writes steps[first] on as G-code. The machine's axes point the other
+  // way from the table's, so coordinates are negated. Starting anywhere but
+  // at 0 only makes sense at a rapid.
+  void write(GCodeWriter& writer, size_t first = 0) const;
+
+private:
+  uint32_t currentCut() const;
+  void     extend(Point2d p);
+};
+
+#endif
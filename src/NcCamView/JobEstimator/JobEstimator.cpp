@@ -0,0 +1,423 @@
+#include "JobEstimator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <string_view>
+
+namespace {
+
+// Estimates a run is kept for after the last one to use it
+constexpr uint64_t cache_estimates = 8;
+// Run keys hold coordinates in these steps, so that a run moved across the
+// table still matches itself after rounding
+constexpr double key_scale = 1e5;
+// Shorter lines are left out, as GRBL leaves out lines of no steps
+constexpr double min_block_length = 1e-6;
+// From GRBL: the slowest feed it plans (1 mm/min) and the angle within which
+// an arc's ends count as the same point
+constexpr double minimum_feed_rate = 1.0 / 60.0;
+constexpr double arc_angular_travel_epsilon = 5e-7;
+
+// Fastest rate (or acceleration) along `ux, uy, uz` that keeps every axis
+// within its own `maximum`
+double limitByAxis(const std::array<double, 3>& maximum,
+                   double                       ux,
+                   double                       uy,
+                   double                       uz = 0.0)
+{
+  double       limit = std::numeric_limits<double>::infinity();
+  const double unit[3] = { ux, uy, uz };
+  for (int axis = 0; axis < 3; axis++) {
+    if (unit[axis] != 0.0)
+      limit = std::min(limit, std::abs(maximum[axis] / unit[axis]));
+  }
+  return limit;
+}
+
+// Seconds to cover `length` entering at sqrt(entry_sqr) and leaving at
+// sqrt(exit_sqr), accelerating and braking at `acceleration` and cruising at
+// sqrt(nominal_sqr) if it gets there
+double profileTime(double entry_sqr,
+                   double exit_sqr,
+                   double nominal_sqr,
+                   double acceleration,
+                   double length)
+{
+  const double entry = std::sqrt(entry_sqr);
+  const double exit = std::sqrt(exit_sqr);
+  const double accelerate = (nominal_sqr - entry_sqr) / (2.0 * acceleration);
+  const double brake = (nominal_sqr - exit_sqr) / (2.0 * acceleration);
+  if (accelerate + brake <= length) {
+    const double nominal = std::sqrt(nominal_sqr);
+    return (nominal - entry) / acceleration + (nominal - exit) / acceleration +
+           (length - accelerate - brake) / nominal;
+  }
+  // A triangle: it has to brake before reaching the nominal speed
+  const double peak = std::sqrt(std::max(
+    { 0.5 * (entry_sqr + exit_sqr) + acceleration * length, entry_sqr,
+      exit_sqr }));
+  return (peak - entry) / acceleration + (peak - exit) / acceleration;
+}
+
+// Axis limits in mm/s and mm/s^2; zeros, as a machine that was never set up
+// has, would make every move take forever
+std::array<double, 3> axisRates(const JobEstimator::Machine& machine)
+{
+  std::array<double, 3> rates;
+  for (int axis = 0; axis < 3; axis++)
+    rates[axis] = std::max(machine.max_vel[axis], 1.0) / 60.0;
+  return rates;
+}
+
+std::array<double, 3> axisAccelerations(const JobEstimator::Machine& machine)
+{
+  std::array<double, 3> accelerations;
+  for (int axis = 0; axis < 3; axis++)
+    accelerations[axis] = std::max(machine.max_accel[axis], 1.0);
+  return accelerations;
+}
+
+// Seconds for a Z move of `distance` from rest to rest at `feed` (mm/min),
+// or as a rapid when `feed` is 0
+double zMove(const JobEstimator::Machine& machine, double distance, double feed)
+{
+  if (distance <= 0.0)
+    return 0.0;
+  double rate = axisRates(machine)[2];
+  if (feed > 0.0)
+    rate = std::max(std::min(feed / 60.0, rate), minimum_feed_rate);
+  return profileTime(
+    0.0, 0.0, rate * rate, axisAccelerations(machine)[2], distance);
+}
+
+// Angle an arc from `from` to `to` about from + `offset` turns through,
+// positive counter-clockwise, the way GRBL's mc_arc works it out. Ends that
+// meet make a full circle.
+double arcTravel(Point2d from, Point2d to, Point2d offset, bool ccw)
+{
+  const Point2d center{ from.x + offset.x, from.y + offset.y };
+  const double  r0 = -offset.x;
+  const double  r1 = -offset.y;
+  const double  rt0 = to.x - center.x;
+  const double  rt1 = to.y - center.y;
+  double travel = std::atan2(r0 * rt1 - r1 * rt0, r0 * rt0 + r1 * rt1);
+  if (ccw) {
+    if (travel <= arc_angular_travel_epsilon)
+      travel += 2.0 * std::numbers::pi;
+  }
+  else {
+    if (travel >= -arc_angular_travel_epsilon)
+      travel -= 2.0 * std::numbers::pi;
+  }
+  return travel;
+}
+
+// GRBL's planner for one run: blocks go in as the lines are received and
+// come out timed once the run has stopped
+class Planner {
+public:
+  Planner(const JobEstimator::Machine& machine, Point2d from)
+    : m_machine(machine), m_rates(axisRates(machine)),
+      m_accelerations(axisAccelerations(machine)), m_position(from)
+  {
+  }
+
+  // Line to `to` at `feed` (mm/min), or a rapid when `feed` is 0
+  void line(Point2d to, double feed, uint32_t cut)
+  {
+    const double dx = to.x - m_position.x;
+    const double dy = to.y - m_position.y;
+    const double length = std::hypot(dx, dy);
+    m_position = to;
+    if (length < min_block_length)
+      return;
+    const double ux = dx / length;
+    const double uy = dy / length;
+
+    Block        block{ length, 0.0, 0.0, 0.0, cut };
+    const double rapid_rate = limitByAxis(m_rates, ux, uy);
+    const double nominal = std::max(
+      feed > 0.0 ? std::min(feed / 60.0, rapid_rate) : rapid_rate,
+      minimum_feed_rate);
+    block.nominal_sqr = nominal * nominal;
+    block.acceleration = limitByAxis(m_accelerations, ux, uy);
+    if (!m_blocks.empty()) {
+      // Junction deviation: the corner speed of a circle `deviation` from
+      // the corner, tangent to both lines, taken at the acceleration the
+      // axes allow in the direction the velocity turns
+      const double cos_theta = -(m_unit.x * ux + m_unit.y * uy);
+      double       junction_sqr;
+      if (cos_theta > 0.999999) {
+        junction_sqr = 0.0; // Reverses
+      }
+      else if (cos_theta < -0.999999) {
+        junction_sqr = std::numeric_limits<double>::infinity(); // Straight on
+      }
+      else {
+        const double jx = ux - m_unit.x;
+        const double jy = uy - m_unit.y;
+        const double jl = std::hypot(jx, jy);
+        const double sin_theta_d2 = std::sqrt(0.5 * (1.0 - cos_theta));
+        junction_sqr = limitByAxis(m_accelerations, jx / jl, jy / jl) *
+                       m_machine.junction_deviation * sin_theta_d2 /
+                       (1.0 - sin_theta_d2);
+      }
+      block.max_entry_sqr = std::min(
+        { junction_sqr, block.nominal_sqr, m_blocks.back().nominal_sqr });
+    }
+    m_unit = { ux, uy };
+    m_blocks.push_back(block);
+  }
+
+  // Arc to `to` about the current position + `offset`, in the straight
+  // segments GRBL cuts it into to stay within its arc tolerance
+  void arc(Point2d to, Point2d offset, bool ccw, double feed, uint32_t cut)
+  {
+    const Point2d center{ m_position.x + offset.x, m_position.y + offset.y };
+    const double  travel = arcTravel(m_position, to, offset, ccw);
+    const double  radius = std::hypot(offset.x, offset.y);
+    const double  tolerance = m_machine.arc_tolerance;
+    size_t        segments = 0;
+    if (tolerance > 0.0 && 2.0 * radius > tolerance) {
+      segments =
+        static_cast<size_t>(std::floor(std::abs(0.5 * travel * radius) /
+                                       std::sqrt(tolerance *
+                                                 (2.0 * radius - tolerance))));
+    }
+    const double start = std::atan2(-offset.y, -offset.x);
+    for (size_t i = 1; i < segments; i++) {
+      const double angle = start + travel * i / segments;
+      line({ center.x + radius * std::cos(angle),
+             center.y + radius * std::sin(angle) },
+           feed,
+           cut);
+    }
+    line(to, feed, cut);
+  }
+
+  // Adds the seconds of each block to `seconds[block.cut]`. Each block
+  // leaves as fast as the blocks the planner holds with it allow, the last
+  // of them having to come to a stop.
+  void time(std::vector<double>& seconds) const
+  {
+    const size_t lookahead = std::max<size_t>(m_machine.planner_blocks, 1);
+    double       entry_sqr = 0.0;
+    for (size_t i = 0; i < m_blocks.size(); i++) {
+      const size_t end = std::min(m_blocks.size(), i + lookahead);
+      double       exit_sqr = 0.0;
+      for (size_t j = end - 1; j > i; j--) {
+        const Block& next = m_blocks[j];
+        exit_sqr = std::min(next.max_entry_sqr,
+                            exit_sqr + 2.0 * next.acceleration * next.length);
+      }
+      const Block& block = m_blocks[i];
+      exit_sqr = std::min(exit_sqr,
+                          entry_sqr + 2.0 * block.acceleration * block.length);
+      seconds[block.cut] += profileTime(entry_sqr,
+                                        exit_sqr,
+                                        block.nominal_sqr,
+                                        block.acceleration,
+                                        block.length);
+      entry_sqr = exit_sqr;
+    }
+  }
+
+private:
+  // Speeds squared, in (mm/s)^2
+  struct Block {
+    double   length;
+    double   nominal_sqr;
+    double   max_entry_sqr;
+    double   acceleration; // mm/s^2
+    uint32_t cut;
+  };
+
+  const JobEstimator::Machine& m_machine;
+  std::array<double, 3>        m_rates;
+  std::array<double, 3>        m_accelerations;
+  Point2d                      m_position;
+  Point2d                      m_unit = { 0.0, 0.0 }; // Of the last block
+  std::vector<Block>           m_blocks;
+};
+
+bool isMotion(Program::Op op)
+{
+  // torch_off_async goes out without waiting for the machine to stop
+  return op == Program::Op::Rapid || op == Program::Op::Line ||
+         op == Program::Op::ArcCw || op == Program::Op::ArcCcw ||
+         op == Program::Op::TorchOffAsync;
+}
+
+} // namespace
+
+JobEstimator::Estimate JobEstimator::estimate(const Program& program,
+                                              const Machine& machine)
+{
+  if (!(machine == m_machine)) {
+    m_runs.clear();
+    m_machine = machine;
+  }
+  m_estimate++;
+  std::erase_if(m_runs, [&](const auto& run) {
+    return run.second.estimate + cache_estimates <= m_estimate;
+  });
+
+  Estimate estimate;
+  estimate.parts.resize(program.parts.size());
+  Totals     unowned; // Steps of no part, should there be any
+  const auto totalsOf = [&](uint32_t cut) -> Totals& {
+    if (cut < program.cuts.size() &&
+        program.cuts[cut].part < estimate.parts.size())
+      return estimate.parts[program.cuts[cut].part];
+    return unowned;
+  };
+
+  const std::vector<Program::Step>& steps = program.steps;
+  Point2d                           position = { 0.0, 0.0 };
+  size_t                            s = 0;
+  while (s < steps.size()) {
+    // Motion up to the next command that waits for the machine to stop
+    const size_t  first = s;
+    const Point2d from = position;
+    for (; s < steps.size() && isMotion(steps[s].op); s++) {
+      const Program::Step& step = steps[s];
+      Totals&              totals = totalsOf(step.cut);
+      const double         distance =
+        std::hypot(step.to.x - position.x, step.to.y - position.y);
+      switch (step.op) {
+        case Program::Op::Rapid:
+          totals.rapid_length += distance;
+          break;
+        case Program::Op::Line:
+          totals.cut_length += distance;
+          break;
+        case Program::Op::ArcCw:
+        case Program::Op::ArcCcw:
+          totals.cut_length +=
+            std::hypot(step.center.x, step.center.y) *
+            std::abs(arcTravel(
+              position, step.to, step.center, step.op == Program::Op::ArcCcw));
+          break;
+        default:
+          break;
+      }
+      position = step.to;
+    }
+    if (s > first) {
+      const std::vector<double>& seconds = planRun(program, first, s, from);
+      for (size_t cut = 0; cut < seconds.size(); cut++)
+        totalsOf(steps[first].cut + cut).seconds += seconds[cut];
+    }
+    if (s == steps.size())
+      break;
+
+    const Program::Step& step = steps[s++];
+    Totals&              totals = totalsOf(step.cut);
+    const Program::Cut*  cut =
+      step.cut < program.cuts.size() ? &program.cuts[step.cut] : nullptr;
+    switch (step.op) {
+      case Program::Op::FireTorch:
+        // Probes down to the material, rises by the floating head backlash
+        // and on to the pierce height (two rapids GRBL runs as one), pierces
+        // and drops to the cut height
+        totals.pierces++;
+        if (cut) {
+          totals.seconds +=
+            zMove(machine, machine.probe_depth, machine.z_probe_feedrate) +
+            zMove(machine,
+                  machine.floating_head_backlash + cut->pierce_height,
+                  0.0) +
+            cut->pierce_delay +
+            zMove(machine, cut->pierce_height - cut->cut_height, 0.0);
+        }
+        break;
+      case Program::Op::TorchOff:
+        // Retracts to Z0 from the cut height
+        if (cut) {
+          totals.seconds += zMove(machine,
+                                  machine.probe_depth -
+                                    machine.floating_head_backlash -
+                                    cut->cut_height,
+                                  0.0);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  estimate.total = unowned;
+  for (const Totals& part : estimate.parts) {
+    estimate.total.seconds += part.seconds;
+    estimate.total.cut_length += part.cut_length;
+    estimate.total.rapid_length += part.rapid_length;
+    estimate.total.pierces += part.pierces;
+  }
+  return estimate;
+}
+
+const std::vector<double>& JobEstimator::planRun(const Program& program,
+                                                 size_t         first,
+                                                 size_t         last,
+                                                 Point2d        from)
+{
+  const std::vector<Program::Step>& steps = program.steps;
+  const uint32_t                    first_cut = steps[first].cut;
+  const auto                        quantize = [](double value) {
+    return static_cast<int64_t>(std::llround(value * key_scale));
+  };
+  std::vector<int64_t> key;
+  key.reserve((last - first) * 6);
+  for (size_t s = first; s < last; s++) {
+    const Program::Step& step = steps[s];
+    key.push_back(static_cast<int64_t>(step.op) |
+                  static_cast<int64_t>(step.cut - first_cut) << 8);
+    key.push_back(std::bit_cast<uint32_t>(step.feed));
+    key.push_back(quantize(step.to.x - from.x));
+    key.push_back(quantize(step.to.y - from.y));
+    key.push_back(quantize(step.center.x));
+    key.push_back(quantize(step.center.y));
+  }
+  const std::string_view bytes(reinterpret_cast<const char*>(key.data()),
+                               key.size() * sizeof(int64_t));
+  const size_t           hash = std::hash<std::string_view>{}(bytes);
+  auto [it, end] = m_runs.equal_range(hash);
+  for (; it != end; ++it) {
+    if (it->second.key == key) {
+      it->second.estimate = m_estimate;
+      return it->second.seconds;
+    }
+  }
+
+  Planner planner(m_machine, from);
+  for (size_t s = first; s < last; s++) {
+    const Program::Step& step = steps[s];
+    const uint32_t       cut = step.cut - first_cut;
+    switch (step.op) {
+      case Program::Op::Rapid:
+        planner.line(step.to, 0.0, cut);
+        break;
+      case Program::Op::Line:
+        planner.line(step.to, step.feed, cut);
+        break;
+      case Program::Op::ArcCw:
+      case Program::Op::ArcCcw:
+        planner.arc(step.to,
+                    step.center,
+                    step.op == Program::Op::ArcCcw,
+                    step.feed,
+                    cut);
+        break;
+      default:
+        break;
+    }
+  }
+  Run run{ std::move(key),
+           std::vector<double>(steps[last - 1].cut - first_cut + 1, 0.0),
+           m_estimate };
+  planner.time(run.seconds);
+  return m_runs.emplace(hash, std::move(run))->second.seconds;
+}
@@ -0,0 +1,76 @@
+#ifndef JOB_ESTIMATOR_
+#define JOB_ESTIMATOR_
+
+#include <NcCamView/GCodeWriter/Program.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Works out how long the machine takes to run a Program by planning its
+// moves the way GRBL does. Every line, and every segment GRBL cuts an arc
+// into, is a block with a trapezoidal speed profile; corners are taken as
+// fast as junction deviation allows, and the planner only sees as many
+// blocks ahead as its buffer holds, so it always has to be able to stop at
+// the last of them. Torch commands add the Z moves and dwells the motion
+// controller carries them out with. Not counted: how long the arc takes to
+// strike, and the planner running dry when lines can't be streamed fast
+// enough.
+//
+// Stretches of motion between stops are planned once and remembered by
+// their shape, wherever on the table they are, so estimating again after
+// parts have moved only plans the rapids between them afresh. An estimator
+// is not thread safe.
+class JobEstimator {
+public:
+  // The machine, in the units of its parameters: mm/min for rates and
+  // mm/s^2 for accelerations
+  struct Machine {
+    std::array<double, 3> max_vel = { 0.0, 0.0, 0.0 };
+    std::array<double, 3> max_accel = { 0.0, 0.0, 0.0 };
+    double                junction_deviation = 0.0;
+    double                z_probe_feedrate = 0.0;
+    double                floating_head_backlash = 0.0;
+    // Z travel from the retracted torch down to the material
+    double                probe_depth = 0.0;
+    // GRBL's $12, as the motion controller sets it
+    double                arc_tolerance = 0.002;
+    // Blocks GRBL plans ahead, 15 on an Arduino
+    size_t                planner_blocks = 15;
+
+    bool operator==(const Machine&) const = default;
+  };
+  struct Totals {
+    double seconds = 0.0;
+    double cut_length = 0.0; // Feed moves, bridges and overburn included
+    double rapid_length = 0.0;
+    size_t pierces = 0;
+  };
+  struct Estimate {
+    Totals              total;
+    std::vector<Totals> parts; // By Program::parts
+  };
+
+  Estimate estimate(const Program& program, const Machine& machine);
+
+private:
+  // Seconds a stretch of motion that starts and ends at rest takes
+  struct Run {
+    std::vector<int64_t> key;     // Its steps, relative to where it starts
+    std::vector<double>  seconds; // By cut, from the first it moves in
+    uint64_t             estimate; // Last estimate to use it
+  };
+
+  const std::vector<double>& planRun(const Program& program,
+                                     size_t         first,
+                                     size_t         last,
+                                     Point2d        from);
+
+  Machine                              m_machine;
+  std::unordered_multimap<size_t, Run> m_runs;
+  uint64_t                             m_estimate = 0;
+};
+
+#endif
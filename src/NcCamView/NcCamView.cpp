@@ -2,18 +2,22 @@
 #include "../Input/InputEvents.h"
 #include "../Input/InputState.h"
 #include "../NcApp/NcApp.h"
+#include "CutSequencer/CutSequencer.h"
 #include "DXFParsePathAdaptor/DXFParsePathAdaptor.h"
 #include "NcControlView/NcControlView.h"
 #include "PolyNest/PolyNest.h"
 #include <ImGuiFileDialog.h>
 #include <NcControlView/util.h>
 #include <NcRender/NcRender.h>
+#include <NcRender/WorkerPool.h>
 #include <ThemeManager/ThemeManager.h>
 #include <dxflib/dl_dxf.h>
 #include <imgui.h>
 #include <loguru.hpp>
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <filesystem>
 #include <numbers>
 NcCamView::~NcCamView()
 {
@@ -34,7 +38,11 @@ void NcCamView::to_json(nlohmann::json& j, const ToolData& tool)
                       { "thc", tool.thc },
                       { "small_hole_feedrate_factor",
                         tool.small_hole_feedrate_factor },
-                      { "overburn_length", tool.overburn_length } };
+                      { "overburn_length", tool.overburn_length },
+                      { "arc_tolerance", tool.arc_tolerance },
+                      { "chain_cut", tool.chain_cut },
+                      { "max_bridge_length", tool.max_bridge_length },
+                      { "chain_min_part_size", tool.chain_min_part_size } };
 }
 
 void NcCamView::from_json(const nlohmann::json& j, ToolData& tool)
@@ -48,6 +56,47 @@ void NcCamView::from_json(const nlohmann::json& j, ToolData& tool)
   tool.thc = j.at("thc").get<float>();
   tool.small_hole_feedrate_factor = j.value("small_hole_feedrate_factor", 0.6f);
   tool.overburn_length = j.value("overburn_length", 4.0f);
+  tool.arc_tolerance = j.value("arc_tolerance", 0.025f);
+  tool.chain_cut = j.value("chain_cut", false);
+  tool.max_bridge_length = j.value("max_bridge_length", 10.0f);
+  tool.chain_min_part_size = j.value("chain_min_part_size", 50.0f);
+}
+
+// JSON serialization for Remnant
+void NcCamView::to_json(nlohmann::json& j, const Remnant& remnant)
+{
+  nlohmann::json contours = nlohmann::json::array();
+  for (const auto& contour : remnant.contours) {
+    nlohmann::json points = nlohmann::json::array();
+    for (const auto& p : contour)
+      points.push_back({ p.x, p.y });
+    contours.push_back(points);
+  }
+  j = nlohmann::json{ { "name", remnant.name }, { "contours", contours } };
+}
+
+void NcCamView::from_json(const nlohmann::json& j, Remnant& remnant)
+{
+  remnant.name = j.at("name").get<std::string>();
+  remnant.contours.clear();
+  for (const auto& points : j.at("contours")) {
+    std::vector<Point2d> contour;
+    for (const auto& p : points)
+      contour.push_back({ p.at(0).get<double>(), p.at(1).get<double>() });
+    remnant.contours.push_back(std::move(contour));
+  }
+}
+
+// Copies made by DuplicatePartAction are named "<master>:<n>"
+static std::string masterPartName(const std::string& name)
+{
+  size_t colon = name.rfind(':');
+  if (colon == std::string::npos || colon + 1 == name.size() ||
+      !std::all_of(name.begin() + colon + 1, name.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+      }))
+    return name;
+  return name.substr(0, colon);
 }
 
 // Static reference to current instance for callback access
@@ -221,6 +270,7 @@ void NcCamView::RenderUI()
                  show_tool_edit,
                  show_edit_tool_operation,
                  selected_part);
+  renderEstimateWindow();
 }
 
 // ============================================================================
@@ -417,7 +467,15 @@ void NcCamView::renderMenuBar(bool& show_job_options, bool& show_tool_library)
       }
       if (ImGui::MenuItem("Send to Controller", "", false, has_toolpaths)) {
         LOG_F(INFO, "File->Send to Controller");
-        m_action_stack.push_back(std::make_unique<SendToControllerAction>());
+        m_action_stack.push_back(
+          std::make_unique<SendToControllerAction>(m_active_sheet));
+      }
+      bool can_save_remnant =
+        !m_operation.in_progress && !getAllParts().empty();
+      if (ImGui::MenuItem("Save Remnant", "", false, can_save_remnant)) {
+        LOG_F(INFO, "File->Save Remnant");
+        m_action_stack.push_back(
+          std::make_unique<SaveRemnantAction>(m_active_sheet));
       }
       // ImGui::Separator();
       // if (ImGui::MenuItem("Save Job", "")) {
@@ -470,6 +528,9 @@ void NcCamView::renderMenuBar(bool& show_job_options, bool& show_tool_library)
             "Show Kerf Width", "", &m_show_kerf_width)) {
         LOG_F(INFO, "View->Show Kerf Width: %d", m_show_kerf_width);
       }
+      if (ImGui::MenuItem("Job Estimate", "", &m_show_estimate)) {
+        LOG_F(INFO, "View->Job Estimate: %d", m_show_estimate);
+      }
       ImGui::EndMenu();
     }
     if (ImGui::BeginMenu("Workbench")) {
@@ -597,6 +658,15 @@ void NcCamView::renderPropertiesWindow(Part*& selected_part)
     ImGui::Text("Offset Y: %.4f", selected_part->m_control.offset.y);
     ImGui::InputDouble("Scale", &selected_part->m_control.scale);
     ImGui::InputDouble("Angle", &selected_part->m_control.angle);
+    static const char* rotation_names[] = { "Free", "0/180 Only", "Fixed" };
+    int                rotation = static_cast<int>(nestRotation(selected_part));
+    if (ImGui::Combo("Nest Rotation",
+                     &rotation,
+                     rotation_names,
+                     IM_ARRAYSIZE(rotation_names))) {
+      m_nest_rotation[masterPartName(selected_part->m_part_name)] =
+        static_cast<PolyNest::RotationMode>(rotation);
+    }
     ImGui::SliderFloat("Simplification",
                        &selected_part->m_control.smoothing,
                        0.001f,
@@ -654,6 +724,59 @@ void NcCamView::renderLeftPane(bool&  show_create_operation,
       ImGui::SetNextItemWidth(avail_w - inner_spacing - height_label_w);
       ImGui::InputFloat("Height", &m_job_options.material_size[1]);
     }
+    ImGui::SetNextItemWidth(std::max(avail_w * 0.5f, 40.0f));
+    const char* material_name =
+      m_job_options.remnant >= 0
+        ? m_remnants[m_job_options.remnant].name.c_str()
+        : "Full sheet";
+    if (ImGui::BeginCombo("Material", material_name)) {
+      if (ImGui::Selectable("Full sheet", m_job_options.remnant < 0)) {
+        m_job_options.remnant = -1;
+      }
+      for (size_t i = 0; i < m_remnants.size(); i++) {
+        bool is_selected = m_job_options.remnant == static_cast<int>(i);
+        ImGui::PushID(static_cast<int>(i));
+        if (ImGui::Selectable(m_remnants[i].name.c_str(), is_selected)) {
+          m_job_options.remnant = static_cast<int>(i);
+        }
+        ImGui::PopID();
+        if (is_selected) {
+          ImGui::SetItemDefaultFocus();
+        }
+      }
+      ImGui::EndCombo();
+    }
+    if (m_job_options.remnant >= 0) {
+      ImGui::SameLine();
+      if (ImGui::Button("Delete Remnant")) {
+        m_remnants.erase(m_remnants.begin() + m_job_options.remnant);
+        m_job_options.remnant = -1;
+        saveRemnants();
+      }
+    }
+    ImGui::SetNextItemWidth(std::max(avail_w * 0.5f, 40.0f));
+    ImGui::BeginDisabled(m_job_options.remnant >= 0);
+    if (ImGui::InputInt("Sheets", &m_job_options.sheet_count)) {
+      m_job_options.sheet_count = std::clamp(m_job_options.sheet_count, 1, 99);
+    }
+    ImGui::EndDisabled();
+    ImGui::SetNextItemWidth(std::max(avail_w * 0.5f, 40.0f));
+    if (ImGui::InputFloat("Nest Time Limit (s)",
+                          &m_job_options.nest_time_limit)) {
+      m_job_options.nest_time_limit =
+        std::max(m_job_options.nest_time_limit, 0.0f);
+    }
+    ImGui::Checkbox("Fast Nesting", &m_job_options.fast_nesting);
+    ImGui::Checkbox("Genetic Nesting", &m_job_options.genetic_nesting);
+    ImGui::SetNextItemWidth(std::max(avail_w * 0.5f, 40.0f));
+    if (ImGui::InputInt("G-code Decimals", &m_job_options.gcode_decimals)) {
+      m_job_options.gcode_decimals =
+        std::clamp(m_job_options.gcode_decimals, 1, 6);
+    }
+    if (gcodeDecimals() != m_job_options.gcode_decimals) {
+      ImGui::SameLine();
+      ImGui::Text("(%d while arcs are fitted)", gcodeDecimals());
+    }
     ImGui::Text("Origin Corner");
     auto same_line_if_fits = [&](const char* next_label) {
       float next_w = ImGui::GetFrameHeight() + inner_spacing +
@@ -697,6 +820,8 @@ void NcCamView::renderLeftPane(bool&  show_create_operation,
       default:
         break;
     }
+    updateSheetPlanes();
+    updateRemnantOutline();
     if (ImGui::Button("Close")) {
       show_job_options = false;
     }
@@ -722,6 +847,10 @@ void NcCamView::renderLeftPane(bool&  show_create_operation,
     ImGui::InputFloat("small_hole_feedrate_factor",
                       &tool.small_hole_feedrate_factor);
     ImGui::InputFloat("overburn_length", &tool.overburn_length);
+    ImGui::InputFloat("arc_tolerance", &tool.arc_tolerance);
+    ImGui::Checkbox("chain_cut", &tool.chain_cut);
+    ImGui::InputFloat("max_bridge_length", &tool.max_bridge_length);
+    ImGui::InputFloat("chain_min_part_size", &tool.chain_min_part_size);
 
     if (ImGui::Button("OK")) {
       bool skip_save = false;
@@ -733,7 +862,10 @@ void NcCamView::renderLeftPane(bool&  show_create_operation,
           tool.feed_rate < 0.f || tool.feed_rate > 50000.f || tool.thc < 0.f ||
           tool.thc > 50000.f || tool.small_hole_feedrate_factor <= 0.f ||
           tool.small_hole_feedrate_factor > 1.f || tool.overburn_length < 0.f ||
-          tool.overburn_length > 50000.f) {
+          tool.overburn_length > 50000.f || tool.arc_tolerance < 0.f ||
+          tool.arc_tolerance > 10.f || tool.max_bridge_length < 0.f ||
+          tool.max_bridge_length > 50000.f || tool.chain_min_part_size < 0.f ||
+          tool.chain_min_part_size > 50000.f) {
         LOG_F(WARNING, "Invalid tool input parameters.");
         skip_save = true;
       }
@@ -788,6 +920,10 @@ void NcCamView::renderLeftPane(bool&  show_create_operation,
     ImGui::InputFloat("small_hole_feedrate_factor",
                       &edit_tool.small_hole_feedrate_factor);
     ImGui::InputFloat("overburn_length", &edit_tool.overburn_length);
+    ImGui::InputFloat("arc_tolerance", &edit_tool.arc_tolerance);
+    ImGui::Checkbox("chain_cut", &edit_tool.chain_cut);
+    ImGui::InputFloat("max_bridge_length", &edit_tool.max_bridge_length);
+    ImGui::InputFloat("chain_min_part_size", &edit_tool.chain_min_part_size);
 
     if (ImGui::Button("OK")) {
       bool skip_save = false;
@@ -801,7 +937,12 @@ void NcCamView::renderLeftPane(bool&  show_create_operation,
           edit_tool.small_hole_feedrate_factor <= 0.f ||
           edit_tool.small_hole_feedrate_factor > 1.f ||
           edit_tool.overburn_length < 0.f ||
-          edit_tool.overburn_length > 50000.f) {
+          edit_tool.overburn_length > 50000.f ||
+          edit_tool.arc_tolerance < 0.f || edit_tool.arc_tolerance > 10.f ||
+          edit_tool.max_bridge_length < 0.f ||
+          edit_tool.max_bridge_length > 50000.f ||
+          edit_tool.chain_min_part_size < 0.f ||
+          edit_tool.chain_min_part_size > 50000.f) {
         LOG_F(WARNING, "Invalid tool input parameters.");
         skip_save = true;
       }
@@ -1055,12 +1196,18 @@ void NcCamView::renderLeftPane(bool&  show_create_operation,
   // Calculate fixed button area height (buttons never move)
   int   failed = m_operation.failed_count.load();
   bool  operation_in_progress = m_operation.in_progress.load();
-  float button_area_height = ImGui::GetFrameHeightWithSpacing() * 3.f;
+  int   used_sheets = usedSheetCount();
+  float button_area_height =
+    ImGui::GetFrameHeightWithSpacing() * (used_sheets > 1 ? 4.f : 3.f);
 
   // Extra height for progress/warning rendered above the fixed buttons
   float extra_height = 0;
+  bool nesting_in_progress =
+    operation_in_progress &&
+    m_operation.type == BackgroundOperationType::Nesting;
   if (operation_in_progress) {
-    extra_height += ImGui::GetFrameHeightWithSpacing() * 3.0f;
+    extra_height += ImGui::GetFrameHeightWithSpacing() *
+                    (nesting_in_progress ? 4.0f : 3.0f);
   }
   if (failed > 0) {
     extra_height += ImGui::GetTextLineHeightWithSpacing() * 2.5f;
@@ -1099,6 +1246,12 @@ void NcCamView::renderLeftPane(bool&  show_create_operation,
     float progress = m_operation.progress.load();
     ImGui::ProgressBar(progress, ImVec2(-1, 0));
     ImGui::TextWrapped("%s", m_operation.status_text.c_str());
+    if (nesting_in_progress) {
+      // Keeps the layout shown now; remaining sheets get a quick pass
+      if (ImGui::Button("Accept Now", ImVec2(-1, 0))) {
+        m_dxf_nest.requestStop();
+      }
+    }
     ImGui::Separator();
   }
 
@@ -1140,8 +1293,17 @@ void NcCamView::renderLeftPane(bool&  show_create_operation,
     ImGuiFileDialog::Instance()->OpenDialog(
       "PostNcDialog", "Choose File", ".nc", config);
   }
+  if (used_sheets > 1) {
+    // Pick which sheet's program goes to the controller
+    m_active_sheet = std::clamp(m_active_sheet, 0, used_sheets - 1);
+    int sheet_number = m_active_sheet + 1;
+    ImGui::SetNextItemWidth(-1);
+    if (ImGui::SliderInt("##sheet", &sheet_number, 1, used_sheets, "Sheet %d"))
+      m_active_sheet = sheet_number - 1;
+  }
   if (ImGui::Button("Send to Controller", ImVec2(-1, 0))) {
-    m_action_stack.push_back(std::make_unique<SendToControllerAction>());
+    m_action_stack.push_back(
+      std::make_unique<SendToControllerAction>(m_active_sheet));
   }
   ImGui::EndDisabled();
 
@@ -1320,6 +1482,93 @@ void NcCamView::renderOperationsViewer(bool& show_create_operation,
   ImGui::EndTable();
 }
 
+void NcCamView::renderEstimateWindow()
+{
+  if (!m_show_estimate)
+    return;
+  ImGui::Begin(
+    "Job Estimate", &m_show_estimate, ImGuiWindowFlags_AlwaysAutoResize);
+  ImGui::SetNextItemWidth(120.0f);
+  if (ImGui::InputFloat("Probe Depth (mm)", &m_job_options.probe_depth)) {
+    m_job_options.probe_depth = std::max(m_job_options.probe_depth, 0.0f);
+  }
+  if (ImGui::IsItemHovered()) {
+    ImGui::SetTooltip("How far the torch travels down from its retracted "
+                      "height to the material");
+  }
+  if (m_estimate_version < m_estimate_state->version.load())
+    ImGui::Text("Estimating...");
+  else
+    ImGui::Text("Estimated from the machine parameters");
+
+  const auto duration = [](double seconds) {
+    const long total = std::lround(seconds);
+    char       text[32];
+    std::snprintf(text,
+                  sizeof(text),
+                  "%ldh %02ldm %02lds",
+                  total / 3600,
+                  (total % 3600) / 60,
+                  total % 60);
+    return std::string(text);
+  };
+  const auto row = [&](const std::string&            name,
+                       const JobEstimator::Totals& totals) {
+    ImGui::TableNextRow();
+    ImGui::TableSetColumnIndex(0);
+    ImGui::Text("%s", name.c_str());
+    ImGui::TableSetColumnIndex(1);
+    ImGui::Text("%s", duration(totals.seconds).c_str());
+    ImGui::TableSetColumnIndex(2);
+    ImGui::Text("%.2f", totals.cut_length / 1000.0);
+    ImGui::TableSetColumnIndex(3);
+    ImGui::Text("%.2f", totals.rapid_length / 1000.0);
+    ImGui::TableSetColumnIndex(4);
+    ImGui::Text("%lu", totals.pierces);
+  };
+  const auto header = [](const char* first) {
+    ImGui::TableSetupColumn(first);
+    ImGui::TableSetupColumn("Time");
+    ImGui::TableSetupColumn("Cut (m)");
+    ImGui::TableSetupColumn("Rapid (m)");
+    ImGui::TableSetupColumn("Pierces");
+    ImGui::TableHeadersRow();
+  };
+
+  if (ImGui::BeginTable(
+        "Sheets", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+    header("Sheet");
+    JobEstimator::Totals job;
+    for (size_t sheet = 0; sheet < m_estimates.size(); sheet++) {
+      const JobEstimator::Totals& totals = m_estimates[sheet].estimate.total;
+      row("Sheet " + std::to_string(sheet + 1), totals);
+      job.seconds += totals.seconds;
+      job.cut_length += totals.cut_length;
+      job.rapid_length += totals.rapid_length;
+      job.pierces += totals.pierces;
+    }
+    if (m_estimates.size() > 1)
+      row("Job", job);
+    ImGui::EndTable();
+  }
+
+  // Parts of the sheet that would be sent to the controller
+  const size_t sheet = static_cast<size_t>(std::max(m_active_sheet, 0));
+  if (sheet < m_estimates.size() &&
+      ImGui::CollapsingHeader(
+        ("Parts on sheet " + std::to_string(sheet + 1)).c_str())) {
+    const SheetEstimate& estimate = m_estimates[sheet];
+    if (ImGui::BeginTable(
+          "Parts", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+      header("Part");
+      for (size_t part = 0; part < estimate.parts.size(); part++)
+        row(estimate.parts[part], estimate.estimate.parts[part]);
+      ImGui::EndTable();
+    }
+  }
+  ImGui::End();
+}
+
 void NcCamView::deletePart(std::string part_name)
 {
   if (!m_app)
@@ -1400,32 +1649,191 @@ std::vector<std::string> NcCamView::getAllLayers()
 void NcCamView::resetNesting()
 {
   m_dxf_nest = PolyNest::PolyNest();
+  if (m_nfp_cache) {
+    m_dxf_nest.setNfpCache(m_nfp_cache);
+  }
   m_dxf_nest.setExtents(
     { m_material_plane->m_bottom_left.x, m_material_plane->m_bottom_left.y },
     { m_material_plane->m_bottom_left.x + m_material_plane->m_width,
       m_material_plane->m_bottom_left.y + m_material_plane->m_height });
+  std::vector<std::vector<PolyNest::PolyPoint>> material = remnantMaterial();
+  if (!material.empty()) {
+    m_dxf_nest.setMaterial(material);
+  }
+  m_dxf_nest.setSheets(sheetCount(), SHEET_SPACING);
+  m_dxf_nest.setTimeBudget(m_job_options.nest_time_limit);
+  m_dxf_nest.setEvaluator(m_job_options.fast_nesting
+                            ? PolyNest::NestEvaluator::Raster
+                            : PolyNest::NestEvaluator::Exact);
+  m_dxf_nest.setOptimizer(m_job_options.genetic_nesting
+                            ? PolyNest::NestOptimizer::Genetic
+                            : PolyNest::NestOptimizer::Annealing);
+}
+
+double NcCamView::sheetPitch() const
+{
+  return m_material_plane->m_width + SHEET_SPACING;
+}
+
+int NcCamView::sheetOfPart(Part* part) const
+{
+  double center_x = (part->m_bb_min.x + part->m_bb_max.x) * 0.5;
+  int    sheet = static_cast<int>(
+    std::floor((center_x - m_material_plane->m_bottom_left.x) / sheetPitch()));
+  return std::clamp(sheet, 0, sheetCount() - 1);
+}
+
+int NcCamView::usedSheetCount()
+{
+  int used = 1;
+  forEachVisiblePart(
+    [&](Part* part) { used = std::max(used, sheetOfPart(part) + 1); });
+  return used;
+}
+
+void NcCamView::updateSheetPlanes()
+{
+  if (!m_app)
+    return;
+  auto&  renderer = m_app->getRenderer();
+  size_t extra = static_cast<size_t>(sheetCount() - 1);
+  if (m_sheet_planes.size() != extra) {
+    renderer.deletePrimitivesById("material_sheet");
+    m_sheet_planes.clear();
+    for (size_t i = 0; i < extra; i++) {
+      Box* sheet = renderer.pushPrimitive<Box>(Point2d{ 0, 0 }, 0, 0, 0);
+      sheet->id = "material_sheet";
+      sheet->flags = PrimitiveFlags::MaterialPlane;
+      sheet->zindex = -20;
+      sheet->color = &m_app->getColor(ThemeColor::CuttablePlaneColor);
+      sheet->matrix_callback = getTransformCallback();
+      sheet->mouse_callback = m_material_plane->mouse_callback;
+      m_sheet_planes.push_back(sheet);
+    }
+  }
+  for (size_t i = 0; i < m_sheet_planes.size(); i++) {
+    Box* sheet = m_sheet_planes[i];
+    sheet->m_bottom_left = { m_material_plane->m_bottom_left.x +
+                               static_cast<double>(i + 1) * sheetPitch(),
+                             m_material_plane->m_bottom_left.y };
+    sheet->m_width = m_material_plane->m_width;
+    sheet->m_height = m_material_plane->m_height;
+  }
+}
+
+int NcCamView::sheetCount() const
+{
+  return m_job_options.remnant >= 0 ? 1 : m_job_options.sheet_count;
+}
+
+std::vector<std::vector<PolyNest::PolyPoint>>
+NcCamView::remnantMaterial() const
+{
+  std::vector<std::vector<PolyNest::PolyPoint>> material;
+  if (m_job_options.remnant < 0 ||
+      m_job_options.remnant >= static_cast<int>(m_remnants.size())) {
+    return material;
+  }
+  const Point2d& origin = m_material_plane->m_bottom_left;
+  for (const auto& contour : m_remnants[m_job_options.remnant].contours) {
+    std::vector<PolyNest::PolyPoint> points;
+    for (const auto& p : contour) {
+      points.push_back(PolyNest::PolyPoint(origin.x + p.x, origin.y + p.y));
+    }
+    material.push_back(std::move(points));
+  }
+  return material;
+}
+
+void NcCamView::loadRemnants()
+{
+  auto&          renderer = m_app->getRenderer();
+  std::string    filename = renderer.getConfigDirectory() + "remnants.json";
+  nlohmann::json remnants = renderer.parseJsonFromFile(filename);
+  if (remnants == NULL) {
+    return;
+  }
+  try {
+    for (const auto& remnant_json : remnants) {
+      Remnant remnant;
+      NcCamView::from_json(remnant_json, remnant);
+      if (!remnant.contours.empty()) {
+        m_remnants.push_back(std::move(remnant));
+      }
+    }
+  }
+  catch (const nlohmann::json::exception& e) {
+    LOG_F(ERROR, "Could not parse %s: %s", filename.c_str(), e.what());
+  }
+  LOG_F(INFO, "Loaded %zu remnants", m_remnants.size());
+}
+
+void NcCamView::saveRemnants()
+{
+  auto&          renderer = m_app->getRenderer();
+  nlohmann::json remnants = nlohmann::json::array();
+  for (const auto& remnant : m_remnants) {
+    nlohmann::json remnant_json;
+    NcCamView::to_json(remnant_json, remnant);
+    remnants.push_back(remnant_json);
+  }
+  renderer.dumpJsonToFile(renderer.getConfigDirectory() + "remnants.json",
+                          remnants);
+}
+
+void NcCamView::updateRemnantOutline()
+{
+  if (!m_app)
+    return;
+  auto& renderer = m_app->getRenderer();
+  auto  material = remnantMaterial();
+  if (m_remnant_drawn != m_job_options.remnant) {
+    renderer.deletePrimitivesById("material_remnant");
+    m_remnant_paths.clear();
+    for (size_t i = 0; i < material.size(); i++) {
+      Path* path = renderer.pushPrimitive<Path>(std::vector<Point2d>{});
+      path->id = "material_remnant";
+      path->zindex = -10;
+      path->color = &m_app->getColor(ThemeColor::PlotLinesHovered);
+      path->matrix_callback = getTransformCallback();
+      m_remnant_paths.push_back(path);
+    }
+    m_remnant_drawn = m_job_options.remnant;
+  }
+  // Points follow the material plane when the origin corner changes
+  for (size_t i = 0; i < m_remnant_paths.size(); i++) {
+    Path* path = m_remnant_paths[i];
+    path->m_points.clear();
+    for (const auto& p : material[i]) {
+      path->m_points.push_back({ p.x, p.y });
+    }
+    path->invalidateHitCache();
+  }
 }
 
 std::vector<std::vector<PolyNest::PolyPoint>>
-NcCamView::collectOutsideContours(Part* part)
+NcCamView::collectNestingContours(Part* part)
 {
   std::vector<std::vector<PolyNest::PolyPoint>> poly_part;
   for (auto& [layer_name, layer] : part->m_layers) {
     for (auto& path : layer.paths) {
-      if (!path.is_inside_contour) {
+      // Closed holes let smaller parts nest inside this one
+      if (!path.is_inside_contour || path.is_closed) {
         // Use cached simplified points, or simplify on demand
-        if (path.simplified_points.empty()) {
+        if (!path.simplified_points) {
+          auto simplified = std::make_shared<std::vector<Point2d>>();
           if (path.is_closed && path.points.size() <= 6) {
-            path.simplified_points = path.points;
+            *simplified = path.points;
           }
           else {
             part->simplify(
-              path.points, path.simplified_points, part->m_control.smoothing);
+              path.points, *simplified, part->m_control.smoothing);
           }
+          path.simplified_points = std::move(simplified);
         }
         std::vector<PolyNest::PolyPoint> points;
-        points.reserve(path.simplified_points.size());
-        for (const auto& p : path.simplified_points) {
+        points.reserve(path.simplified_points->size());
+        for (const auto& p : *path.simplified_points) {
           points.push_back({ p.x, p.y });
         }
         poly_part.push_back(std::move(points));
@@ -1435,6 +1843,13 @@ NcCamView::collectOutsideContours(Part* part)
   return poly_part;
 }
 
+PolyNest::RotationMode NcCamView::nestRotation(const Part* part) const
+{
+  auto it = m_nest_rotation.find(masterPartName(part->m_part_name));
+  return it != m_nest_rotation.end() ? it->second
+                                     : PolyNest::RotationMode::Free;
+}
+
 void NcCamView::reevaluateContours()
 {
   // Collect all paths from all parts with their layer information
@@ -1532,176 +1947,487 @@ void NcCamView::reevaluateContours()
 // Action Handler Methods
 // ============================================================================
 
-// Generate G-code lines from current toolpath operations
-std::vector<std::string> NcCamView::generateGCode()
+int NcCamView::gcodeDecimals() const
 {
-  std::vector<std::string> lines;
+  // G2/G3 words are rounded one by one, and GRBL rejects an arc whose
+  // rounded ends and centre disagree on its radius by more than 0.005 mm
+  // (error 33). Three decimals keep that well inside; fewer don't.
+  constexpr int arc_decimals = 3;
+  for (const auto& operation : m_toolpath_operations) {
+    auto tool_it = m_tool_library.find(operation.tool_name);
+    if (tool_it != m_tool_library.end() &&
+        tool_it->second.arc_tolerance > 0.0f)
+      return std::max(m_job_options.gcode_decimals, arc_decimals);
+  }
+  return m_job_options.gcode_decimals;
+}
+
+std::string NcCamView::programKey(int sheet)
+{
+  const double sheet_dx = sheet > 0 ? sheet * sheetPitch() : 0.0;
+  std::string  key = std::to_string(gcodeDecimals()) + " " +
+                    std::to_string(sheet_dx);
+  for (const auto& operation : m_toolpath_operations) {
+    nlohmann::json tool;
+    auto           tool_it = m_tool_library.find(operation.tool_name);
+    if (tool_it != m_tool_library.end())
+      to_json(tool, tool_it->second);
+    key += " " + operation.tool_name + tool.dump();
+  }
+  forEachVisiblePart([&](Part* part) {
+    if (sheet >= 0 && sheetOfPart(part) != sheet)
+      return;
+    key += " " + std::to_string(part->m_toolpaths_stamp);
+  });
+  return key;
+}
+
+// Generate the program of the current toolpath operations
+std::shared_ptr<const Program> NcCamView::generateProgram(int sheet)
+{
+  // Toolpaths build in the background; wait for any still in flight so the
+  // output matches what is on screen
+  forEachVisiblePart([](Part* part) { part->finishToolpaths(); });
+
+  std::string   key = programKey(sheet);
+  GCodeProgram& cached = m_gcode_programs[sheet];
+  if (cached.program && cached.key == key) {
+    LOG_F(INFO,
+          "Job unchanged, reusing its program of %lu steps",
+          cached.program->steps.size());
+    return cached.program;
+  }
+  auto program = buildProgram(programInput(sheet), m_program_caches);
+  cached.key = std::move(key);
+  cached.program = program;
+  return program;
+}
+
+NcCamView::ProgramInput NcCamView::programInput(int sheet)
+{
+  // Each sheet is cut in its own coordinates, as if it were the first sheet
+  const double sheet_dx = sheet > 0 ? sheet * sheetPitch() : 0.0;
+  ProgramInput input;
+  input.decimals = gcodeDecimals();
+  m_gcode_generation++;
+
+  // Every toolpath on the sheet, sequenced as one job rather than part by
+  // part, so rapids don't criss-cross the table between parts. Parts whose
+  // toolpaths haven't changed since the last run bring them from there.
+  size_t parts_reused = 0;
+  forEachVisiblePart([&](Part* part) {
+    if (sheet >= 0 && sheetOfPart(part) != sheet)
+      return;
+    const size_t   first = input.toolpaths.size();
+    GCodeFragment& fragment = m_gcode_fragments[part];
+    if (fragment.generation != 0 &&
+        fragment.stamp == part->m_toolpaths_stamp &&
+        fragment.sheet_dx == sheet_dx) {
+      parts_reused++;
+    }
+    else {
+      fragment.stamp = part->m_toolpaths_stamp;
+      fragment.sheet_dx = sheet_dx;
+      fragment.toolpaths = part->getOrderedToolpaths();
+      if (sheet_dx != 0.0) {
+        for (auto& tp : fragment.toolpaths) {
+          for (auto& pt : tp.points)
+            pt.x -= sheet_dx;
+        }
+      }
+    }
+    fragment.generation = m_gcode_generation;
+    input.toolpaths.insert(input.toolpaths.end(),
+                           fragment.toolpaths.begin(),
+                           fragment.toolpaths.end());
+    // Tagged with the part, which the program names
+    for (size_t x = first; x < input.toolpaths.size(); x++)
+      input.toolpaths[x].tag = input.parts.size();
+    input.parts.push_back(part->m_part_name);
+  });
+  LOG_F(INFO,
+        "Reused the toolpaths of %lu of %lu parts",
+        parts_reused,
+        input.parts.size());
+
+  for (const auto& operation : m_toolpath_operations) {
+    ProgramInput::Operation& op = input.operations.emplace_back();
+    op.layer = operation.layer;
+    auto tool_it = m_tool_library.find(operation.tool_name);
+    if (tool_it != m_tool_library.end())
+      op.tool = tool_it->second;
+  }
+
+  // Forget what recent runs, e.g. for other sheets, have not needed
+  const uint64_t oldest =
+    m_gcode_generation - std::min<uint64_t>(m_gcode_generation, 8);
+  std::erase_if(m_gcode_fragments, [&](const auto& entry) {
+    return entry.second.generation <= oldest;
+  });
+  return input;
+}
 
-  for (size_t i = 0; i < m_toolpath_operations.size(); i++) {
+std::shared_ptr<Program> NcCamView::buildProgram(const ProgramInput& input,
+                                                 ProgramCaches&      caches)
+{
+  auto program = std::make_shared<Program>();
+  program->decimals = input.decimals;
+  program->parts = input.parts;
+  caches.generation++;
+
+  std::vector<Part::Toolpath> tool_paths = input.toolpaths;
+  // Chain cutting needs neighbouring outlines to follow each other
+  bool chain_cut = false;
+  for (const auto& operation : input.operations)
+    chain_cut |= operation.tool && operation.tool->chain_cut;
+  const CutSequencer::Stats sequence = CutSequencer::sequence(
+    tool_paths, { 0.0, 0.0 }, chain_cut, &caches.entry_cache);
+  LOG_F(INFO,
+        "Sequenced %lu toolpaths (%lu entries moved), rapid travel %.0f -> "
+        "%.0f",
+        sequence.toolpaths,
+        sequence.entries_moved,
+        sequence.rapid_before,
+        sequence.rapid_after);
+
+  for (size_t i = 0; i < input.operations.size(); i++) {
     LOG_F(INFO,
           "Generating toolpath operation: %lu on layer: %s",
           i,
-          m_toolpath_operations[i].layer.c_str());
-
-    forEachVisiblePart([&](Part* part) {
-      std::vector<Part::Toolpath> tool_paths = part->getOrderedToolpaths();
-
-      auto tool_it = m_tool_library.find(m_toolpath_operations[i].tool_name);
-      if (tool_it != m_tool_library.end()) {
-        const auto& tool = tool_it->second;
-
-        const bool thc_enabled = tool.thc > 0;
-
-        // Disable THC and reduce feed on contours with small area.
-        const double small_area_threshold = (12.5 * tool.kerf_width) *
-                                            (12.5 * tool.kerf_width) *
-                                            std::numbers::pi;
-
-        for (size_t x = 0; x < tool_paths.size(); x++) {
-          const auto&  tp = tool_paths[x];
-          const auto&  pts = tp.points;
-          if (pts.empty())
-            continue;
-
-          // contour_first / contour_last bound the cyclic contour vertices
-          // inside `pts`. Vertices before contour_first are lead-in (arc or
-          // straight pierce); the trailing lead_out_count vertices are the
-          // closing duplicate plus any real lead-out (outside contours).
-          const size_t contour_first = tp.lead_in_count;
-          const size_t contour_last = pts.size() - 1 - tp.lead_out_count;
-
-          // Area-based gates (THC and feedrate factor) use the contour
-          // vertices only — arc lead-in points would otherwise inflate the
-          // shoelace.
-          const double area = geo::polygonArea(
-            pts, contour_first, contour_last + 1);
-          const bool   small_contour = area < small_area_threshold;
-          const float  path_thc =
-            (thc_enabled && !small_contour) ? tool.thc : 0.0f;
-          const float feed =
-            small_contour ? tool.feed_rate * tool.small_hole_feedrate_factor
-                          : tool.feed_rate;
-
-          lines.push_back("G0 X" + std::to_string(-pts[0].x) + " Y" +
-                          std::to_string(-pts[0].y));
-          lines.push_back("fire_torch " + std::to_string(tool.pierce_height) +
-                          " " + std::to_string(tool.pierce_delay) + " " +
-                          std::to_string(tool.cut_height) + " " +
-                          std::to_string(path_thc));
-
-          if (tp.is_closed_contour && tp.is_inside_contour) {
-            // Inside (hole): cut the lead-in and the contour up to and
-            // including the last unique contour vertex, then close the kerf
-            // and command the torch off non-blocking exactly at the closed
-            // loop, so the arc keeps cutting through the whole contour and
-            // only starts extinguishing during the overburn tail.
-            for (size_t z = 0; z <= contour_last; z++) {
-              lines.push_back("G1 X" + std::to_string(-pts[z].x) + " Y" +
-                              std::to_string(-pts[z].y) + " F" +
-                              std::to_string(feed));
-            }
+          input.operations[i].layer.c_str());
+
+    if (input.operations[i].tool) {
+      const auto& tool = *input.operations[i].tool;
+
+      const bool thc_enabled = tool.thc > 0;
+
+      // Disable THC and reduce feed on contours with small area.
+      const double small_area_threshold = (12.5 * tool.kerf_width) *
+                                          (12.5 * tool.kerf_width) *
+                                          std::numbers::pi;
+      // Area-based gates (THC and feedrate factor) use the contour
+      // vertices only — arc lead-in points would otherwise inflate the
+      // shoelace.
+      std::vector<bool> small(tool_paths.size());
+      for (size_t x = 0; x < tool_paths.size(); x++) {
+        const auto& tp = tool_paths[x];
+        small[x] = geo::polygonArea(tp.points,
+                                    tp.lead_in_count,
+                                    tp.points.size() - tp.lead_out_count) <
+                   small_area_threshold;
+      }
 
-            if (contour_last > contour_first) {
-              // (1) Close the kerf: ALWAYS return to the contour start vertex
-              // (pts[contour_first], the closing-duplicate point). This seam
-              // edge must be cut in full or the contour is left open. It is
-              // independent of overburn -- with arc leads the start sits
-              // mid-wall, so the seam can be longer than overburn_length, which
-              // previously stopped the closing motion partway and left the path
-              // open (the symptom seen exclusively on arc-lead contours).
-              lines.push_back("G1 X" + std::to_string(-pts[contour_first].x) +
-                              " Y" + std::to_string(-pts[contour_first].y) +
-                              " F" + std::to_string(feed));
-
-              // Command the torch off non-blocking now that the loop is closed
-              // at the contour start vertex. The cut is complete; the arc
-              // extinguishes here, at the very end of the contour, and trails
-              // off during the overburn move below. Firing this before the seam
-              // close (as it once did) let the arc die partway along a long
-              // closing edge -- centimetres early on straight-edged holes.
-              lines.push_back("torch_off_async");
-
-              // (2) Overburn: continue PAST the start vertex into the
-              // already-cut contour so the dying arc overruns the seam. The
-              // budget is measured from the (now closed) start vertex, not from
-              // contour_last, so the seam length no longer eats into it.
-              if (tool.overburn_length > 0.0f) {
-                double       remaining = tool.overburn_length;
-                Point2d      prev = pts[contour_first];
-                const size_t cycle_count = contour_last - contour_first + 1;
-                for (size_t step = 1; step < cycle_count && remaining > 0.0;
-                     step++) {
-                  const Point2d& next =
-                    pts[contour_first + (step % cycle_count)];
-                  const double dx = next.x - prev.x;
-                  const double dy = next.y - prev.y;
-                  const double seg_len = std::sqrt(dx * dx + dy * dy);
-                  if (seg_len <= 0.0) {
-                    prev = next;
-                    continue;
-                  }
-                  if (seg_len >= remaining) {
-                    const double t = remaining / seg_len;
-                    const double ox = prev.x + dx * t;
-                    const double oy = prev.y + dy * t;
-                    lines.push_back("G1 X" + std::to_string(-ox) + " Y" +
-                                    std::to_string(-oy) + " F" +
-                                    std::to_string(feed));
-                    remaining = 0.0;
-                  }
-                  else {
-                    lines.push_back("G1 X" + std::to_string(-next.x) + " Y" +
-                                    std::to_string(-next.y) + " F" +
-                                    std::to_string(feed));
-                    remaining -= seg_len;
-                    prev = next;
-                  }
+      // Chain cutting: a chained toolpath carries on from the end of the one
+      // before it over a bridge, without lifting the torch. Small contours
+      // run at their own feed and THC, so they are always pierced.
+      std::vector<bool> chained(tool_paths.size(), false);
+      if (tool.chain_cut) {
+        chained = CutSequencer::findBridges(
+          tool_paths, tool.max_bridge_length, tool.chain_min_part_size);
+        for (size_t x = 1; x < tool_paths.size(); x++)
+          chained[x] = chained[x] && !small[x] && !small[x - 1];
+      }
+
+      // Cuts from pts[0] through pts[last], fitting arcs where the points
+      // allow
+      auto cut = [&](const std::vector<Point2d>& pts, size_t last, float feed) {
+        for (const geo::ArcMove& move :
+             fitCut(caches, pts, last, tool.arc_tolerance)) {
+          if (move.is_arc)
+            program->arc(move.end, move.center, move.ccw, feed);
+          else
+            program->line(move.end, feed);
+        }
+      };
+
+      for (size_t x = 0; x < tool_paths.size(); x++) {
+        const auto&  tp = tool_paths[x];
+        const auto&  pts = tp.points;
+        if (pts.empty())
+          continue;
+
+        // contour_first / contour_last bound the cyclic contour vertices
+        // inside `pts`. Vertices before contour_first are lead-in (arc or
+        // straight pierce); the trailing lead_out_count vertices are the
+        // closing duplicate plus any real lead-out (outside contours).
+        const size_t contour_first = tp.lead_in_count;
+        const size_t contour_last = pts.size() - 1 - tp.lead_out_count;
+
+        const bool  small_contour = small[x];
+        const float path_thc =
+          (thc_enabled && !small_contour) ? tool.thc : 0.0f;
+        const float feed =
+          small_contour ? tool.feed_rate * tool.small_hole_feedrate_factor
+                        : tool.feed_rate;
+
+        program->beginCut({ static_cast<uint32_t>(tp.tag),
+                            tool.pierce_height,
+                            tool.pierce_delay,
+                            tool.cut_height,
+                            path_thc });
+        if (chained[x]) {
+          // Bridge through the scrap from where the previous cut ended
+          program->line(pts[0], feed);
+        }
+        else {
+          program->rapid(pts[0]);
+          program->command(Program::Op::FireTorch);
+        }
+
+        if (tp.is_closed_contour && tp.is_inside_contour) {
+          // Inside (hole): cut the lead-in and the contour up to and
+          // including the last unique contour vertex, then close the kerf
+          // and command the torch off non-blocking exactly at the closed
+          // loop, so the arc keeps cutting through the whole contour and
+          // only starts extinguishing during the overburn tail.
+          program->line(pts[0], feed);
+          cut(pts, contour_last, feed);
+
+          if (contour_last > contour_first) {
+            // (1) Close the kerf: ALWAYS return to the contour start vertex
+            // (pts[contour_first], the closing-duplicate point). This seam
+            // edge must be cut in full or the contour is left open. It is
+            // independent of overburn -- with arc leads the start sits
+            // mid-wall, so the seam can be longer than overburn_length, which
+            // previously stopped the closing motion partway and left the path
+            // open (the symptom seen exclusively on arc-lead contours).
+            program->line(pts[contour_first], feed);
+
+            // Command the torch off non-blocking now that the loop is closed
+            // at the contour start vertex. The cut is complete; the arc
+            // extinguishes here, at the very end of the contour, and trails
+            // off during the overburn move below. Firing this before the seam
+            // close (as it once did) let the arc die partway along a long
+            // closing edge -- centimetres early on straight-edged holes.
+            program->command(Program::Op::TorchOffAsync);
+
+            // (2) Overburn: continue PAST the start vertex into the
+            // already-cut contour so the dying arc overruns the seam. The
+            // budget is measured from the (now closed) start vertex, not from
+            // contour_last, so the seam length no longer eats into it.
+            if (tool.overburn_length > 0.0f) {
+              double       remaining = tool.overburn_length;
+              Point2d      prev = pts[contour_first];
+              const size_t cycle_count = contour_last - contour_first + 1;
+              for (size_t step = 1; step < cycle_count && remaining > 0.0;
+                   step++) {
+                const Point2d& next =
+                  pts[contour_first + (step % cycle_count)];
+                const double dx = next.x - prev.x;
+                const double dy = next.y - prev.y;
+                const double seg_len = std::sqrt(dx * dx + dy * dy);
+                if (seg_len <= 0.0) {
+                  prev = next;
+                  continue;
+                }
+                if (seg_len >= remaining) {
+                  const double t = remaining / seg_len;
+                  const double ox = prev.x + dx * t;
+                  const double oy = prev.y + dy * t;
+                  program->line({ ox, oy }, feed);
+                  remaining = 0.0;
+                }
+                else {
+                  program->line(next, feed);
+                  remaining -= seg_len;
+                  prev = next;
                 }
               }
             }
-            lines.push_back("torch_off");
-          }
-          else {
-            // Outside contours (closed or open): cut every vertex including
-            // any trailing lead-out duplicate, then sync torch off.
-            for (size_t z = 0; z < pts.size(); z++) {
-              lines.push_back("G1 X" + std::to_string(-pts[z].x) + " Y" +
-                              std::to_string(-pts[z].y) + " F" +
-                              std::to_string(feed));
-            }
-            lines.push_back("torch_off");
           }
+          program->command(Program::Op::TorchOff);
+        }
+        else {
+          // Outside contours (closed or open): cut every vertex including
+          // any trailing lead-out duplicate, then sync torch off -- unless
+          // the next toolpath is chained on and keeps the torch lit.
+          program->line(pts[0], feed);
+          cut(pts, pts.size() - 1, feed);
+          if (x + 1 == tool_paths.size() || !chained[x + 1])
+            program->command(Program::Op::TorchOff);
         }
       }
-      else {
-        LOG_F(WARNING,
-              "Tried generating GCode with tool that no longer exists");
-      }
-    });
+    }
+    else {
+      LOG_F(WARNING,
+            "Tried generating GCode with tool that no longer exists");
+    }
   }
 
-  lines.push_back("M30");
-  return lines;
+  program->command(Program::Op::End);
+  LOG_F(INFO,
+        "Generated a program of %lu steps, %lu cuts",
+        program->steps.size(),
+        program->cuts.size());
+
+  // Forget fits recent runs, e.g. for other sheets, have not needed
+  const uint64_t oldest =
+    caches.generation - std::min<uint64_t>(caches.generation, 8);
+  std::erase_if(caches.cut_fits, [&](const auto& entry) {
+    return entry.second.generation <= oldest;
+  });
+  return program;
 }
 
-// PostProcessAction implementation
-void NcCamView::PostProcessAction::execute(NcCamView* view)
+const std::vector<geo::ArcMove>&
+NcCamView::fitCut(ProgramCaches&              caches,
+                  const std::vector<Point2d>& pts,
+                  size_t                      last,
+                  float                       tolerance)
 {
-  if (!view->m_app)
+  const std::string_view bytes(reinterpret_cast<const char*>(pts.data()),
+                               (last + 1) * sizeof(Point2d));
+  const size_t           hash =
+    std::hash<std::string_view>{}(bytes) ^ std::hash<float>{}(tolerance);
+  auto [it, end] = caches.cut_fits.equal_range(hash);
+  for (; it != end; ++it) {
+    CutFit& fit = it->second;
+    if (fit.tolerance == tolerance && fit.points.size() == last + 1 &&
+        std::memcmp(fit.points.data(), pts.data(), bytes.size()) == 0) {
+      fit.generation = caches.generation;
+      return fit.moves;
+    }
+  }
+  CutFit fit{ { pts.begin(), pts.begin() + last + 1 },
+              tolerance,
+              geo::fitArcs(pts, 0, last, tolerance),
+              caches.generation };
+  return caches.cut_fits.emplace(hash, std::move(fit))->second.moves;
+}
+
+void NcCamView::updateEstimate()
+{
+  {
+    std::lock_guard lock(m_estimate_state->mutex);
+    if (m_estimate_state->result_version > m_estimate_version) {
+      m_estimates = std::move(m_estimate_state->result);
+      m_estimate_version = m_estimate_state->result_version;
+    }
+  }
+  if (!m_app || !m_show_estimate || m_operation.in_progress)
     return;
 
-  std::ofstream gcode_file(m_file);
-  if (!gcode_file.is_open()) {
-    LOG_F(WARNING, "Could not open gcode file for writing!");
+  // Only the inputs are taken here on the render thread, and only once the
+  // job has stayed the same for a moment rather than for every frame of a
+  // part being dragged. Telling whether it has is kept cheap: the stamps
+  // are gathered into a buffer reused from frame to frame and the rest is
+  // compared in place.
+  const int sheets = usedSheetCount();
+  m_estimate_stamps.clear();
+  forEachVisiblePart([&](Part* part) {
+    m_estimate_stamps.push_back(part->m_toolpaths_stamp);
+    m_estimate_stamps.push_back(sheets > 1 ? sheetOfPart(part) : 0);
+  });
+  const JobEstimator::Machine machine = estimateMachine();
+  const double                sheet_pitch = sheetPitch();
+  const int                   decimals = gcodeDecimals();
+  const auto                  now = std::chrono::steady_clock::now();
+  auto                        unchanged = [&](const EstimateInputs& inputs) {
+    return inputs.stamps == m_estimate_stamps &&
+           inputs.tools == m_tool_library &&
+           inputs.operations == m_toolpath_operations &&
+           inputs.sheet_pitch == sheet_pitch && inputs.decimals == decimals &&
+           inputs.machine == machine;
+  };
+  if (!unchanged(m_estimate_seen)) {
+    m_estimate_seen.stamps = m_estimate_stamps;
+    m_estimate_seen.tools = m_tool_library;
+    m_estimate_seen.operations = m_toolpath_operations;
+    m_estimate_seen.sheet_pitch = sheet_pitch;
+    m_estimate_seen.decimals = decimals;
+    m_estimate_seen.machine = machine;
+    m_estimate_seen_time = now;
     return;
   }
+  if (m_estimate_done == m_estimate_seen ||
+      now - m_estimate_seen_time < std::chrono::milliseconds(500))
+    return;
+  bool building = false;
+  forEachVisiblePart([&](Part* part) { building |= part->m_build_pending; });
+  if (building)
+    return;
+  m_estimate_done = m_estimate_seen;
+
+  // Sequencing, arc fitting and building the programs all happen in the
+  // job, with caches of its own
+  std::vector<ProgramInput> inputs;
+  for (int sheet = 0; sheet < sheets; sheet++)
+    inputs.push_back(programInput(sheets > 1 ? sheet : -1));
+  const uint64_t version = ++m_estimate_state->version;
+  WorkerPool::background().submit([state = m_estimate_state,
+                                   version,
+                                   inputs = std::move(inputs),
+                                   machine] {
+    std::vector<SheetEstimate> estimates;
+    {
+      std::lock_guard lock(state->estimator_mutex);
+      for (const auto& input : inputs) {
+        if (state->version.load() != version)
+          return; // Superseded
+        const auto program = buildProgram(input, state->caches);
+        estimates.push_back(
+          { program->parts, state->estimator.estimate(*program, machine) });
+      }
+    }
+    std::lock_guard lock(state->mutex);
+    if (state->version.load() != version)
+      return;
+    state->result = std::move(estimates);
+    state->result_version = version;
+  });
+}
 
-  for (const auto& line : view->generateGCode()) {
-    gcode_file << line << "\n";
+JobEstimator::Machine NcCamView::estimateMachine() const
+{
+  // Settings the motion controller only reads, so read unguarded like the
+  // rest of the render thread does
+  const auto& params = m_app->getControlView().m_machine_parameters;
+  JobEstimator::Machine machine;
+  for (int axis = 0; axis < 3; axis++) {
+    machine.max_vel[axis] = params.max_vel[axis];
+    machine.max_accel[axis] = params.max_accel[axis];
   }
+  machine.junction_deviation = params.junction_deviation;
+  machine.z_probe_feedrate = params.z_probe_feedrate;
+  machine.floating_head_backlash = params.floating_head_backlash;
+  machine.probe_depth = m_job_options.probe_depth;
+  return machine;
+}
+
+// PostProcessAction implementation
+void NcCamView::PostProcessAction::execute(NcCamView* view)
+{
+  if (!view->m_app)
+    return;
+
+  // A job spanning several sheets gets one program per sheet, named
+  // <stem>_sheet<N><ext> next to the chosen file
+  int sheets = view->usedSheetCount();
+  for (int sheet = 0; sheet < sheets; sheet++) {
+    std::string file = m_file;
+    if (sheets > 1) {
+      std::filesystem::path path(m_file);
+      file = (path.parent_path() /
+              (path.stem().string() + "_sheet" + std::to_string(sheet + 1) +
+               path.extension().string()))
+               .string();
+    }
+
+    std::ofstream gcode_file(file);
+    if (!gcode_file.is_open()) {
+      LOG_F(WARNING, "Could not open gcode file for writing!");
+      return;
+    }
 
-  gcode_file.close();
-  LOG_F(INFO, "Finished writing gcode file!");
+    const auto program = view->generateProgram(sheets > 1 ? sheet : -1);
+    {
+      GCodeWriter::StreamSink sink(gcode_file);
+      GCodeWriter             gcode(sink, program->decimals);
+      program->write(gcode);
+    }
+    gcode_file.close();
+    LOG_F(INFO, "Finished writing gcode file %s!", file.c_str());
+  }
 }
 
 // SendToControllerAction implementation
@@ -1710,8 +2436,76 @@ void NcCamView::SendToControllerAction::execute(NcCamView* view)
   if (!view->m_app)
     return;
 
-  view->m_app->getControlView().loadGCodeFromLines(view->generateGCode());
-  LOG_F(INFO, "Sent G-code to controller!");
+  int sheets = view->usedSheetCount();
+  int sheet = sheets > 1 ? std::min(m_sheet, sheets - 1) : -1;
+  view->m_app->getControlView().loadProgram(view->generateProgram(sheet));
+  if (sheet >= 0)
+    LOG_F(INFO, "Sent G-code for sheet %d to controller!", sheet + 1);
+  else
+    LOG_F(INFO, "Sent G-code to controller!");
+}
+
+// SaveRemnantAction implementation
+void NcCamView::SaveRemnantAction::execute(NcCamView* view)
+{
+  if (!view->m_app)
+    return;
+
+  // Material of the sheet being saved, with its parts as placed obstacles
+  int      sheet = std::clamp(m_sheet, 0, view->usedSheetCount() - 1);
+  Box*     plane = view->m_material_plane;
+  Point2d  origin = { plane->m_bottom_left.x + sheet * view->sheetPitch(),
+                      plane->m_bottom_left.y };
+  PolyNest::PolyNest nest;
+  nest.setExtents({ origin.x, origin.y },
+                  { origin.x + plane->m_width, origin.y + plane->m_height });
+  std::vector<std::vector<PolyNest::PolyPoint>> material =
+    view->remnantMaterial();
+  if (!material.empty()) {
+    nest.setMaterial(material);
+  }
+  view->forEachVisiblePart([&](Part* part) {
+    if (view->sheetOfPart(part) != sheet)
+      return;
+    nest.pushPlacedPolyPart(view->collectNestingContours(part),
+                            &part->m_control.offset.x,
+                            &part->m_control.offset.y,
+                            &part->m_control.angle,
+                            &part->visible);
+  });
+
+  std::vector<std::vector<PolyNest::PolyPoint>> remnant =
+    nest.computeRemnant(MIN_REMNANT_WIDTH);
+  if (remnant.empty()) {
+    LOG_F(WARNING, "No usable material left to save as a remnant");
+    return;
+  }
+
+  Remnant saved;
+  double  min_x = std::numeric_limits<double>::infinity();
+  double  min_y = min_x, max_x = -min_x, max_y = -min_x;
+  for (const auto& contour : remnant) {
+    std::vector<Point2d> points;
+    for (const auto& p : contour) {
+      points.push_back({ p.x - origin.x, p.y - origin.y });
+      min_x = std::min(min_x, p.x);
+      min_y = std::min(min_y, p.y);
+      max_x = std::max(max_x, p.x);
+      max_y = std::max(max_y, p.y);
+    }
+    saved.contours.push_back(std::move(points));
+  }
+  char name[64];
+  std::snprintf(name,
+                sizeof(name),
+                "Remnant %zu (%.0f x %.0f)",
+                view->m_remnants.size() + 1,
+                max_x - min_x,
+                max_y - min_y);
+  saved.name = name;
+  LOG_F(INFO, "Saved %s", saved.name.c_str());
+  view->m_remnants.push_back(std::move(saved));
+  view->saveRemnants();
 }
 
 // RebuildToolpathsAction implementation
@@ -1811,7 +2605,7 @@ void NcCamView::DuplicatePartAction::execute(NcCamView* view)
 
   // Add existing parts to nesting
   view->forEachPart([&](Part* part) {
-    auto poly_part = view->collectOutsideContours(part);
+    auto poly_part = view->collectNestingContours(part);
     view->m_dxf_nest.pushPlacedPolyPart(poly_part,
                                         &part->m_control.offset.x,
                                         &part->m_control.offset.y,
@@ -1829,7 +2623,7 @@ void NcCamView::DuplicatePartAction::execute(NcCamView* view)
   for (const auto& [layer_name, layer] : master_part->m_layers) {
     layers_copy[layer_name] = layer;
   }
-  auto poly_part = view->collectOutsideContours(master_part);
+  auto poly_part = view->collectNestingContours(master_part);
 
   // Create duplicate outside any iteration (avoids iterator invalidation)
   Part* new_part = renderer.pushPrimitive<Part>(
@@ -1856,7 +2650,8 @@ void NcCamView::DuplicatePartAction::execute(NcCamView* view)
                                         &new_part->m_control.offset.x,
                                         &new_part->m_control.offset.y,
                                         &new_part->m_control.angle,
-                                        &new_part->visible);
+                                        &new_part->visible,
+                                        view->nestRotation(new_part));
 
   view->m_dxf_nest.beginPlaceUnplacedPolyParts();
   view->startNestingThread();
@@ -1875,12 +2670,13 @@ void NcCamView::ArrangePartsAction::execute(NcCamView* view)
     part->m_control.angle = 0;
     part->visible = false;
 
-    auto poly_part = view->collectOutsideContours(part);
+    auto poly_part = view->collectNestingContours(part);
     view->m_dxf_nest.pushUnplacedPolyPart(poly_part,
                                           &part->m_control.offset.x,
                                           &part->m_control.offset.y,
                                           &part->m_control.angle,
-                                          &part->visible);
+                                          &part->visible,
+                                          view->nestRotation(part));
   });
 
   view->m_dxf_nest.beginPlaceUnplacedPolyParts();
@@ -1889,17 +2685,9 @@ void NcCamView::ArrangePartsAction::execute(NcCamView* view)
 
 void NcCamView::startNestingThread()
 {
-  // Handle previous background thread
+  // Join any previous background thread
   if (m_background_thread && m_background_thread->joinable()) {
-    // Check if we're being called from within the background thread itself
-    if (std::this_thread::get_id() == m_background_thread->get_id()) {
-      // Detach the current thread so it can finish independently
-      m_background_thread->detach();
-    }
-    else {
-      // Join from a different thread (normal case)
-      m_background_thread->join();
-    }
+    m_background_thread->join();
   }
 
   // Setup operation state
@@ -1909,6 +2697,7 @@ void NcCamView::startNestingThread()
   m_operation.in_progress = true;
   m_operation.progress = 0.0f;
   m_operation.failed_count = 0;
+  m_nest_preview_version = 0;
 
   // Launch thread
   m_background_thread = std::make_unique<std::thread>([this]() {
@@ -1951,12 +2740,13 @@ void NcCamView::startImportThread(BackgroundOperationType type,
         if (part and pPrimitive->view == renderer.getCurrentView() and
             part->m_part_name == part_name) {
           part->visible = false; // Hidden until nesting places it
-          auto poly_part = collectOutsideContours(part);
+          auto poly_part = collectNestingContours(part);
           m_dxf_nest.pushUnplacedPolyPart(poly_part,
                                           &part->m_control.offset.x,
                                           &part->m_control.offset.y,
                                           &part->m_control.angle,
-                                          &part->visible);
+                                          &part->visible,
+                                          nestRotation(part));
         }
       }
 
@@ -1969,9 +2759,10 @@ void NcCamView::startImportThread(BackgroundOperationType type,
       m_dl_dxf.reset();
       m_svg_creation_interface.reset();
 
-      // Chain to nesting operation
+      // Chain to nesting operation; tick() starts it once this thread is
+      // done and can be joined
       m_dxf_nest.beginPlaceUnplacedPolyParts();
-      startNestingThread();
+      m_nesting_pending = true;
     });
 }
 
@@ -1987,7 +2778,7 @@ bool NcCamView::dxfFileOpen(std::string filename,
   if (m_dxf_fp) {
     resetNesting();
     forEachPart([&](Part* part) {
-      auto poly_part = collectOutsideContours(part);
+      auto poly_part = collectNestingContours(part);
       m_dxf_nest.pushPlacedPolyPart(poly_part,
                                     &part->m_control.offset.x,
                                     &part->m_control.offset.y,
@@ -2039,7 +2830,7 @@ bool NcCamView::svgFileOpen(std::string filename,
   // nanosvg opens the file itself, so there's no FILE* to hold here.
   resetNesting();
   forEachPart([&](Part* part) {
-    auto poly_part = collectOutsideContours(part);
+    auto poly_part = collectNestingContours(part);
     m_dxf_nest.pushPlacedPolyPart(poly_part,
                                   &part->m_control.offset.x,
                                   &part->m_control.offset.y,
@@ -2109,6 +2900,10 @@ void NcCamView::preInit()
       "Could not find %s!",
       std::string(renderer.getConfigDirectory() + "tool_library.json").c_str());
   }
+
+  m_nfp_cache = std::make_shared<PolyNest::NfpCache>();
+  m_nfp_cache->load(renderer.getConfigDirectory() + "nfp_cache.bin");
+  loadRemnants();
 }
 void NcCamView::init()
 {
@@ -2134,6 +2929,7 @@ void NcCamView::init()
     [this](Primitive* c, const Primitive::MouseEventData& e) {
       mouseEventCallback(c, e);
     };
+  updateSheetPlanes();
   // TODO: Implement SetShowFPS in NcApp if needed
 }
 void NcCamView::tick()
@@ -2185,6 +2981,16 @@ void NcCamView::tick()
     }
     m_toolpath_operations[x].last_enabled = m_toolpath_operations[x].enabled;
   }
+  // Nesting chained after an import
+  if (m_nesting_pending && !m_operation.in_progress) {
+    m_nesting_pending = false;
+    startNestingThread();
+  }
+  // Preview the best layout of a running nest and apply its finished
+  // sheets, also those published just before it returned
+  if (m_operation.type == BackgroundOperationType::Nesting)
+    m_dxf_nest.applyBestLayout(m_nest_preview_version);
+  updateEstimate();
   // Process action stack
   // Process all pending actions using virtual dispatch
   while (!m_action_stack.empty()) {
@@ -2211,10 +3017,15 @@ void NcCamView::makeActive()
 }
 void NcCamView::close()
 {
-  // Join background thread before destruction
+  // Join background thread before destruction; a running nest stops early
+  m_dxf_nest.requestStop();
   if (m_background_thread && m_background_thread->joinable()) {
     m_background_thread->join();
   }
+  if (m_app && m_nfp_cache && m_nfp_cache->entryCount() > 0) {
+    m_nfp_cache->save(m_app->getRenderer().getConfigDirectory() +
+                      "nfp_cache.bin");
+  }
 }
 
 void NcCamView::handleScrollEvent(const ScrollEvent& e, const InputState& input)
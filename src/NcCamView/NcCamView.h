@@ -3,10 +3,14 @@
 
 // Standard library includes
 #include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
+#include <unordered_map>
 
 // System includes
 #include <NcRender/NcRender.h>
@@ -18,7 +22,10 @@
 #include <dxflib/dl_dxf.h>
 
 // Local includes
+#include "CutSequencer/CutSequencer.h"
 #include "DXFParsePathAdaptor/DXFParsePathAdaptor.h"
+#include "GCodeWriter/Program.h"
+#include "JobEstimator/JobEstimator.h"
 #include "PolyNest/PolyNest.h"
 #include "SvgParsePathAdaptor/SvgParsePathAdaptor.h"
 
@@ -43,6 +50,10 @@ struct FileDeleter {
 #define DEFAULT_KERF_WIDTH 1.5f
 #define DEFAULT_LEAD_IN (DEFAULT_KERF_WIDTH * 2.0f)
 #define DEFAULT_LEAD_OUT (DEFAULT_LEAD_IN * 0.5f)
+// Gap between consecutive material sheets laid out left to right
+#define SHEET_SPACING 100.0f
+// Narrowest strip of material worth keeping when saving a remnant
+#define MIN_REMNANT_WIDTH 50.0
 
 enum class BackgroundOperationType {
   None,
@@ -77,6 +88,27 @@ private:
   struct JobOptions {
     float material_size[2] = { DEFAULT_MATERIAL_SIZE, DEFAULT_MATERIAL_SIZE };
     int   origin_corner = 2;
+    // Sheets available to nesting; parts overflow onto the next sheet
+    int   sheet_count = 1;
+    // Index into m_remnants to nest into a saved offcut; -1 = full sheets
+    int   remnant = -1;
+    // Seconds a nest may anneal before keeping its best layout; 0 = no limit
+    float nest_time_limit = 0.0f;
+    // Search layouts on a coarse occupancy grid, exact geometry for the best
+    bool  fast_nesting = false;
+    // Search orders and rotations with the genetic algorithm instead of
+    // simulated annealing
+    bool  genetic_nesting = false;
+    // Decimals of the coordinates and feeds in generated G-code
+    int   gcode_decimals = 3;
+    // Z travel from the retracted torch down to the material, for estimates
+    float probe_depth = 25.0f;
+  };
+  // Offcut kept as stock: outline followed by holes, relative to the bottom
+  // left corner of the material plane
+  struct Remnant {
+    std::string                       name;
+    std::vector<std::vector<Point2d>> contours;
   };
   struct ToolData {
     std::string tool_name;
@@ -88,11 +120,24 @@ private:
     float       thc = 0.0f;
     float       small_hole_feedrate_factor = 0.6f;
     float       overburn_length = 4.0f;
+    // Runs of cut points within this distance of a circle go out as one
+    // G2/G3 arc; 0 cuts every segment as G1
+    float       arc_tolerance = 0.025f;
+    // Chain cutting: cut neighbouring part outlines from one pierce, bridging
+    // gaps up to max_bridge_length through the scrap. Parts narrower than
+    // chain_min_part_size are pierced on their own.
+    bool        chain_cut = false;
+    float       max_bridge_length = 10.0f;
+    float       chain_min_part_size = 50.0f;
+
+    bool operator==(const ToolData&) const = default;
   };
 
   // JSON serialization for ToolData
   static void to_json(nlohmann::json& j, const ToolData& tool);
   static void from_json(const nlohmann::json& j, ToolData& tool);
+  static void to_json(nlohmann::json& j, const Remnant& remnant);
+  static void from_json(const nlohmann::json& j, Remnant& remnant);
   enum class OpType {
     Cut,
   };
@@ -104,6 +149,80 @@ private:
     double      lead_in_length = DEFAULT_LEAD_IN;
     double      lead_out_length = DEFAULT_LEAD_OUT;
     std::string layer;
+
+    bool operator==(const ToolOperation&) const = default;
+  };
+  // What generateProgram keeps between runs, so that re-posting a job only
+  // redoes the parts that changed. A part's toolpaths in cut order, kept
+  // while its toolpaths stamp and sheet stay the same:
+  struct GCodeFragment {
+    uint64_t                    stamp = 0;
+    double                      sheet_dx = 0.0;
+    std::vector<Part::Toolpath> toolpaths;
+    uint64_t                    generation = 0; // Last program to use it
+  };
+  // The arc fit of one cut span:
+  struct CutFit {
+    std::vector<Point2d>      points;
+    float                     tolerance;
+    std::vector<geo::ArcMove> moves;
+    uint64_t                  generation; // Last program to use it
+  };
+  // And a whole program with everything it was generated from:
+  struct GCodeProgram {
+    std::string                    key;
+    std::shared_ptr<const Program> program;
+  };
+  // Everything a program is built from, taken on the render thread so that
+  // it can be built on any other: the toolpaths of a sheet's parts in that
+  // sheet's coordinates, tagged with their part, and the tool of each
+  // operation, if it still exists
+  struct ProgramInput {
+    struct Operation {
+      std::string             layer;
+      std::optional<ToolData> tool;
+    };
+    std::vector<Part::Toolpath> toolpaths;
+    std::vector<std::string>    parts;
+    std::vector<Operation>      operations;
+    int                         decimals = 3;
+  };
+  // What buildProgram() keeps between runs. Fits are kept by a hash of their
+  // points. Not thread safe: the render thread and the estimator each have
+  // their own.
+  struct ProgramCaches {
+    std::unordered_multimap<size_t, CutFit> cut_fits;
+    CutSequencer::EntryCache                entry_cache;
+    uint64_t                                generation = 0;
+  };
+  // What the job estimate depends on, cheap to compare every frame: the
+  // toolpaths stamp and sheet of each part, the tools and operations, and
+  // the machine
+  struct EstimateInputs {
+    std::vector<uint64_t>           stamps;
+    std::map<std::string, ToolData> tools;
+    std::vector<ToolOperation>      operations;
+    double                          sheet_pitch = 0.0;
+    int                             decimals = 0;
+    JobEstimator::Machine           machine;
+
+    bool operator==(const EstimateInputs&) const = default;
+  };
+  // Estimate of one sheet's program, with the names of its parts
+  struct SheetEstimate {
+    std::vector<std::string> parts;
+    JobEstimator::Estimate   estimate;
+  };
+  // Shared with the estimate running on the background pool, which drops
+  // its result when another has been submitted since
+  struct EstimateState {
+    std::mutex                 estimator_mutex; // Held while estimating
+    ProgramCaches              caches;
+    JobEstimator               estimator;
+    std::atomic<uint64_t>      version{ 0 };
+    std::mutex                 mutex; // Guards the result
+    uint64_t                   result_version = 0;
+    std::vector<SheetEstimate> result; // By sheet
   };
 
   // Polymorphic Command Pattern for CAM Actions
@@ -168,7 +287,18 @@ private:
   };
 
   class SendToControllerAction : public CamAction {
+    int m_sheet;
+
+  public:
+    explicit SendToControllerAction(int sheet = 0) : m_sheet(sheet) {}
+    void execute(NcCamView* view) override;
+  };
+
+  class SaveRemnantAction : public CamAction {
+    int m_sheet;
+
   public:
+    explicit SaveRemnantAction(int sheet = 0) : m_sheet(sheet) {}
     void execute(NcCamView* view) override;
   };
 
@@ -212,7 +342,48 @@ private:
   void renderOperationsViewer(bool& show_create_operation,
                               int&  show_edit_tool_operation);
   void reevaluateContours();
-  std::vector<std::string> generateGCode();
+  void renderEstimateWindow();
+  // What the program of `sheet` depends on: the output settings, the tools
+  // of the operations and, by their stamps, the toolpaths of the parts
+  std::string programKey(int sheet);
+  // Decimals programs are written with: the job option, but at least 3
+  // while any operation fits arcs
+  int gcodeDecimals() const;
+  // Program for the parts on `sheet` in that sheet's coordinates, or for all
+  // visible parts when `sheet` is negative
+  std::shared_ptr<const Program> generateProgram(int sheet = -1);
+  // Input of the program for `sheet`, parts still building or not
+  ProgramInput programInput(int sheet);
+  // Sequences the toolpaths of `input`, fits arcs to them and builds the
+  // program; touches nothing but its arguments
+  static std::shared_ptr<Program> buildProgram(const ProgramInput& input,
+                                               ProgramCaches&      caches);
+  // Arc fit of pts[0] through pts[last], from `caches` when they were cut
+  // before
+  static const std::vector<geo::ArcMove>&
+  fitCut(ProgramCaches&              caches,
+         const std::vector<Point2d>& pts,
+         size_t                      last,
+         float                       tolerance);
+  // Estimates the job again on the background pool once it has changed and
+  // been left alone for a moment, and picks up estimates that are done
+  void                  updateEstimate();
+  JobEstimator::Machine estimateMachine() const;
+
+  // Multi-sheet layout helpers
+  double sheetPitch() const;
+  int    sheetOfPart(Part* part) const;
+  int    usedSheetCount();
+  // Sheets nesting may use; a remnant is a single piece of material
+  int    sheetCount() const;
+  void   updateSheetPlanes();
+
+  // Remnant library, kept in remnants.json in the config directory
+  void loadRemnants();
+  void saveRemnants();
+  void updateRemnantOutline();
+  // Selected remnant in world coordinates, empty for full sheets
+  std::vector<std::vector<PolyNest::PolyPoint>> remnantMaterial() const;
 
   // Iteration helpers for Part management
   template <typename Func> void forEachPart(Func&& func);
@@ -223,8 +394,10 @@ private:
 
   // Nesting helpers
   void resetNesting();
+  // Outside contours plus closed holes, in part space
   std::vector<std::vector<PolyNest::PolyPoint>>
-  collectOutsideContours(Part* part);
+  collectNestingContours(Part* part);
+  PolyNest::RotationMode nestRotation(const Part* part) const;
 
   Point2d m_show_viewer_context_menu;
   Point2d m_last_mouse_click_position;
@@ -236,6 +409,8 @@ private:
   std::unique_ptr<FILE, FileDeleter>   m_dxf_fp;
   std::unique_ptr<DL_Dxf>              m_dl_dxf;
   PolyNest::PolyNest                   m_dxf_nest;
+  // Outlives the per-run PolyNest; loaded from and saved to the config dir
+  std::shared_ptr<PolyNest::NfpCache>  m_nfp_cache;
   std::unique_ptr<DXFParsePathAdaptor> m_dxf_creation_interface;
   std::unique_ptr<SvgParsePathAdaptor> m_svg_creation_interface;
   bool                                 dxfFileOpen(std::string filename,
@@ -250,6 +425,10 @@ private:
   // Unified threading for all background operations
   std::unique_ptr<std::thread> m_background_thread;
   BackgroundOperationState     m_operation;
+  // Set by an import thread to have tick() start nesting once it has exited
+  std::atomic<bool>            m_nesting_pending{ false };
+  // Last best layout of the running nest shown in the viewport
+  uint64_t                     m_nest_preview_version = 0;
   void                         startNestingThread();
   // Runs `do_import` (parse + finish) on the background thread, then performs
   // the common post-import work (nesting setup for the part, cleanup, chaining
@@ -282,11 +461,42 @@ public:
   // (scales with zoom) rather than thin centerlines. Toggled from View menu,
   // pushed onto each Part every frame in tick().
   bool       m_show_kerf_width = true;
+  // Job estimate window, toggled from the View menu; the job is only
+  // estimated while it is open
+  bool       m_show_estimate = false;
 
   JobOptions                      m_job_options;
   std::map<std::string, ToolData> m_tool_library;
   std::vector<ToolOperation>      m_toolpath_operations;
   Box*                            m_material_plane;
+  // Sheets 2..N, to the right of m_material_plane
+  std::vector<Box*>               m_sheet_planes;
+  // Sheet sent to the controller when the job spans several sheets
+  int                             m_active_sheet = 0;
+  std::vector<Remnant>            m_remnants;
+  // Rotations nesting may give a part, by master part name (so copies share
+  // it); parts not listed rotate freely
+  std::map<std::string, PolyNest::RotationMode> m_nest_rotation;
+  // Outline of the selected remnant, drawn over m_material_plane
+  std::vector<Path*>              m_remnant_paths;
+  int                             m_remnant_drawn = -1;
+  // G-code caches, see GCodeFragment. Programs are kept by sheet, -1 for
+  // all of them.
+  std::unordered_map<const Part*, GCodeFragment> m_gcode_fragments;
+  std::map<int, GCodeProgram>                    m_gcode_programs;
+  uint64_t                                       m_gcode_generation = 0;
+  ProgramCaches                                  m_program_caches;
+  // Job estimates, see updateEstimate(). Inputs as last seen and as last
+  // estimated.
+  std::shared_ptr<EstimateState> m_estimate_state =
+    std::make_shared<EstimateState>();
+  std::vector<SheetEstimate>            m_estimates; // By sheet
+  uint64_t                              m_estimate_version = 0; // Collected
+  EstimateInputs                        m_estimate_seen;
+  std::chrono::steady_clock::time_point m_estimate_seen_time;
+  EstimateInputs                        m_estimate_done;
+  // Reused every frame to gather the parts' stamps
+  std::vector<uint64_t>                 m_estimate_stamps;
 
   // Application context dependency (injected)
   NcApp* m_app{ nullptr };
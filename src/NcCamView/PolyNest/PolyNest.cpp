@@ -1,6 +1,11 @@
 #include "PolyNest.h"
-#include "NanoCut.h"
-#include "NcCamView/NcCamView.h"
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <thread>
 
 // ---------- PolyPart methods (unchanged) ----------
 
@@ -11,10 +16,8 @@ PolyNest::PolyNest()
   m_min_extents = PolyPoint(0, 0);
   m_max_extents = PolyPoint(1000, 1000);
   m_closed_tolerance = 0.1;
-  constexpr int step_size = 5;
-  for (int i = 0; i < 360 / step_size; ++i) {
-    m_allowed_rotations.push_back(i * step_size);
-  }
+  setThreadCount(0);
+  setRotationStep(m_rotation_step);
 }
 
 PolyPoint PolyPart::rotatePoint(PolyPoint p, double a)
@@ -83,6 +86,251 @@ void PolyPart::build()
   getBoundingBox(&m_bbox_min, &m_bbox_max);
 }
 
+// ---------- Bounds / NfpCache methods ----------
+
+void Bounds::extend(const ClipperLib::Path& path)
+{
+  for (const auto& pt : path) {
+    min_x = std::min(min_x, pt.X);
+    min_y = std::min(min_y, pt.Y);
+    max_x = std::max(max_x, pt.X);
+    max_y = std::max(max_y, pt.Y);
+  }
+}
+
+NfpCache::NfpCache(size_t max_bytes) : m_max_bytes(max_bytes) {}
+
+NfpCache::Shard& NfpCache::shardFor(const NfpKey& key)
+{
+  uint64_t h = NfpKeyHash{}(key) * 0x9E3779B97F4A7C15ull;
+  return m_shards[(h >> 32) % kShards];
+}
+
+NfpCache::Entry NfpCache::find(const NfpKey& key)
+{
+  Shard&          shard = shardFor(key);
+  std::lock_guard lock(shard.mutex);
+  auto            it = shard.map.find(key);
+  if (it == shard.map.end()) {
+    m_misses++;
+    return nullptr;
+  }
+  m_hits++;
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  return it->second->nfp;
+}
+
+NfpCache::Entry NfpCache::insert(const NfpKey& key, ClipperLib::Paths nfp)
+{
+  size_t bytes = sizeof(Node) + nfp.size() * sizeof(ClipperLib::Path);
+  for (const auto& path : nfp)
+    bytes += path.size() * sizeof(ClipperLib::FPoint);
+
+  Shard&          shard = shardFor(key);
+  std::lock_guard lock(shard.mutex);
+  auto            it = shard.map.find(key);
+  if (it != shard.map.end())
+    return it->second->nfp;
+
+  shard.lru.push_front(
+    { key, std::make_shared<const ClipperLib::Paths>(std::move(nfp)), bytes });
+  shard.map[key] = shard.lru.begin();
+  shard.bytes += bytes;
+  Entry entry = shard.lru.front().nfp;
+
+  // Evict least recently used entries (never the one just inserted)
+  const size_t shard_cap = m_max_bytes / kShards;
+  while (shard.bytes > shard_cap && shard.lru.size() > 1) {
+    shard.bytes -= shard.lru.back().bytes;
+    shard.map.erase(shard.lru.back().key);
+    shard.lru.pop_back();
+  }
+  return entry;
+}
+
+void NfpCache::clear()
+{
+  for (auto& shard : m_shards) {
+    std::lock_guard lock(shard.mutex);
+    shard.map.clear();
+    shard.lru.clear();
+    shard.bytes = 0;
+  }
+}
+
+void NfpCache::resetCounters()
+{
+  m_hits = 0;
+  m_misses = 0;
+  m_computed = 0;
+  m_compute_us = 0;
+}
+
+void NfpCache::recordCompute(double ms)
+{
+  m_computed++;
+  m_compute_us += static_cast<int64_t>(ms * 1000.0);
+}
+
+size_t NfpCache::sizeBytes()
+{
+  size_t total = 0;
+  for (auto& shard : m_shards) {
+    std::lock_guard lock(shard.mutex);
+    total += shard.bytes;
+  }
+  return total;
+}
+
+size_t NfpCache::entryCount()
+{
+  size_t total = 0;
+  for (auto& shard : m_shards) {
+    std::lock_guard lock(shard.mutex);
+    total += shard.map.size();
+  }
+  return total;
+}
+
+// Binary cache file layout (native byte order):
+//   "NFPC" | u32 version | u64 entry count
+//   per entry: u64 stat_hash | u64 orb_hash | f64 stat_angle | f64 orb_angle
+//              | u8 mode | u32 path count
+//              per path: u32 point count | point count * (f64 X, f64 Y)
+static constexpr char     kNfpCacheMagic[4] = { 'N', 'F', 'P', 'C' };
+static constexpr uint32_t kNfpCacheVersion = 1;
+
+template <typename T> static void writeRaw(std::ostream& out, const T& value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T> static bool readRaw(std::istream& in, T& value)
+{
+  return static_cast<bool>(
+    in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+bool NfpCache::save(const std::string& filename)
+{
+  // Snapshot oldest-first so load() rebuilds the same recency order
+  std::vector<std::pair<NfpKey, Entry>> entries;
+  for (auto& shard : m_shards) {
+    std::lock_guard lock(shard.mutex);
+    for (auto it = shard.lru.rbegin(); it != shard.lru.rend(); ++it)
+      entries.emplace_back(it->key, it->nfp);
+  }
+
+  // Write to a temporary file and rename, so a crash never leaves a
+  // truncated cache behind
+  std::string   tmp_filename = filename + ".tmp";
+  std::ofstream out(tmp_filename, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    LOG_F(WARNING, "Could not write NFP cache %s", tmp_filename.c_str());
+    return false;
+  }
+  out.write(kNfpCacheMagic, sizeof(kNfpCacheMagic));
+  writeRaw(out, kNfpCacheVersion);
+  writeRaw(out, static_cast<uint64_t>(entries.size()));
+  for (const auto& [key, nfp] : entries) {
+    writeRaw(out, key.stat_hash);
+    writeRaw(out, key.orb_hash);
+    writeRaw(out, key.stat_angle);
+    writeRaw(out, key.orb_angle);
+    writeRaw(out, static_cast<uint8_t>(key.mode));
+    writeRaw(out, static_cast<uint32_t>(nfp->size()));
+    for (const auto& path : *nfp) {
+      writeRaw(out, static_cast<uint32_t>(path.size()));
+      for (const auto& pt : path) {
+        writeRaw(out, pt.X);
+        writeRaw(out, pt.Y);
+      }
+    }
+  }
+  out.close();
+  if (!out) {
+    LOG_F(WARNING, "Failed writing NFP cache %s", tmp_filename.c_str());
+    return false;
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp_filename, filename, ec);
+  if (ec) {
+    LOG_F(WARNING,
+          "Could not replace NFP cache %s: %s",
+          filename.c_str(),
+          ec.message().c_str());
+    return false;
+  }
+  LOG_F(INFO, "Saved %zu NFPs to %s", entries.size(), filename.c_str());
+  return true;
+}
+
+bool NfpCache::load(const std::string& filename)
+{
+  std::ifstream in(filename, std::ios::binary);
+  if (!in)
+    return false;
+
+  char     magic[4];
+  uint32_t version = 0;
+  uint64_t count = 0;
+  if (!in.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + 4, kNfpCacheMagic) || !readRaw(in, version) ||
+      version != kNfpCacheVersion || !readRaw(in, count)) {
+    LOG_F(WARNING, "Ignoring NFP cache %s (bad header)", filename.c_str());
+    return false;
+  }
+
+  // Sanity limit on element counts so a corrupt file can't trigger huge
+  // allocations
+  constexpr uint32_t max_elements = 1 << 20;
+  size_t             loaded = 0;
+  for (uint64_t i = 0; i < count; i++) {
+    NfpKey   key;
+    uint8_t  mode;
+    uint32_t path_count;
+    if (!readRaw(in, key.stat_hash) || !readRaw(in, key.orb_hash) ||
+        !readRaw(in, key.stat_angle) || !readRaw(in, key.orb_angle) ||
+        !readRaw(in, mode) || !readRaw(in, path_count) ||
+        path_count > max_elements || mode > 1)
+      break;
+    key.mode = static_cast<NfpMode>(mode);
+
+    ClipperLib::Paths nfp(path_count);
+    bool              ok = true;
+    for (auto& path : nfp) {
+      uint32_t point_count;
+      if (!readRaw(in, point_count) || point_count > max_elements) {
+        ok = false;
+        break;
+      }
+      path.resize(point_count);
+      for (auto& pt : path) {
+        if (!readRaw(in, pt.X) || !readRaw(in, pt.Y)) {
+          ok = false;
+          break;
+        }
+      }
+      if (!ok)
+        break;
+    }
+    if (!ok)
+      break;
+    insert(key, std::move(nfp));
+    loaded++;
+  }
+  if (loaded != count)
+    LOG_F(WARNING,
+          "NFP cache %s is truncated, loaded %zu of %llu entries",
+          filename.c_str(),
+          loaded,
+          static_cast<unsigned long long>(count));
+  else
+    LOG_F(INFO, "Loaded %zu NFPs from %s", loaded, filename.c_str());
+  return loaded > 0;
+}
+
 // ---------- PolyNest helper methods ----------
 
 double PolyNest::PolyNest::measureDistanceBetweenPoints(PolyPoint a,
@@ -184,6 +432,9 @@ PolyPart PolyNest::PolyNest::buildPart(std::vector<std::vector<PolyPoint>> p,
   part.m_offset_y = offset_y;
   part.m_angle = angle;
   part.m_visible = visible;
+  part.m_start_x = *offset_x;
+  part.m_start_y = *offset_y;
+  part.m_start_angle = *angle;
   part.moveOutsidePolyGonToBack();
   part.build();
   return part;
@@ -226,6 +477,56 @@ ClipperLib::Path PolyNest::PolyNest::getBaseContour(const PolyPart& part) const
   return contour;
 }
 
+// Clipper's double-precision port crashes (null edge in IntersectEdges) on
+// edges that are nearly but not exactly coincident, which is what many
+// copies of one shape packed edge-to-edge produce. Inputs of the placement
+// booleans are snapped to a power-of-two grid (cells per mm) so such edges
+// coincide exactly and snapped sums stay exact.
+static constexpr double kSnapGrid = 1024.0;
+
+// Compaction stops once a pass moves no part by more than the tolerance (mm),
+// or after this many passes
+static constexpr double kCompactionTolerance = 0.01;
+static constexpr int    kCompactionPasses = 10;
+
+// Rotation levels of the coarse-to-fine search, see rotationCandidates()
+static constexpr int kRotationLevels = 3;
+
+static double snapToGrid(double v)
+{
+  return std::round(v * kSnapGrid) / kSnapGrid;
+}
+
+// Paths translated by (dx, dy) and snapped to the grid
+static ClipperLib::Paths
+translatePaths(const ClipperLib::Paths& paths, double dx, double dy)
+{
+  ClipperLib::Paths out;
+  out.reserve(paths.size());
+  for (const auto& path : paths) {
+    ClipperLib::Path translated;
+    translated.reserve(path.size());
+    for (const auto& pt : path) {
+      translated.push_back(
+        ClipperLib::FPoint(snapToGrid(pt.X + dx), snapToGrid(pt.Y + dy)));
+    }
+    out.push_back(std::move(translated));
+  }
+  return out;
+}
+
+// NFP(A, B) = A (+) -B, so the world bounds of an obstacle's NFP follow from
+// the obstacle's bounds and the part's extents, without fetching the NFP
+static Bounds nfpBounds(const Bounds& obstacle, const Bounds& part)
+{
+  Bounds box;
+  box.min_x = obstacle.min_x - part.max_x;
+  box.max_x = obstacle.max_x - part.min_x;
+  box.min_y = obstacle.min_y - part.max_y;
+  box.max_y = obstacle.max_y - part.min_y;
+  return box;
+}
+
 // Convex hull using Andrew's monotone chain algorithm.
 // Returns CCW-wound hull.
 static ClipperLib::Path convexHull(ClipperLib::Path points)
@@ -338,45 +639,360 @@ static ClipperLib::Path convexMinkowskiSum(const ClipperLib::Path& P,
   return result;
 }
 
+// ---------- Convex decomposition ----------
+
+// Contours above this size fall back to their hull: ear clipping is cubic in the
+// worst case and the pairwise Minkowski sums grow with the piece count product.
+static constexpr size_t kMaxExactNfpVertices = 400;
+static constexpr double kConvexEpsilon = 1e-9;
+
+static double cross(const ClipperLib::FPoint& o,
+                    const ClipperLib::FPoint& a,
+                    const ClipperLib::FPoint& b)
+{
+  return (a.X - o.X) * (b.Y - o.Y) - (a.Y - o.Y) * (b.X - o.X);
+}
+
+// True if the CCW polygon has no reflex vertex (collinear vertices allowed)
+static bool isConvex(const ClipperLib::Path& poly)
+{
+  size_t n = poly.size();
+  for (size_t i = 0; i < n; i++) {
+    if (cross(poly[(i + n - 1) % n], poly[i], poly[(i + 1) % n]) <
+        -kConvexEpsilon)
+      return false;
+  }
+  return true;
+}
+
+static bool isConvexLoop(const std::vector<size_t>& loop,
+                         const ClipperLib::Path&    pts)
+{
+  size_t n = loop.size();
+  for (size_t i = 0; i < n; i++) {
+    if (cross(pts[loop[(i + n - 1) % n]], pts[loop[i]], pts[loop[(i + 1) % n]]) <
+        -kConvexEpsilon)
+      return false;
+  }
+  return true;
+}
+
+// Ear-clipping triangulation of a simple CCW polygon. Returns false if no ear
+// can be found (self-intersecting or otherwise degenerate input).
+static bool triangulate(const ClipperLib::Path&             poly,
+                        std::vector<std::array<size_t, 3>>& tris)
+{
+  std::vector<size_t> idx(poly.size());
+  std::iota(idx.begin(), idx.end(), 0);
+
+  while (idx.size() > 3) {
+    size_t m = idx.size();
+    bool   clipped = false;
+    for (size_t i = 0; i < m; i++) {
+      size_t a = idx[(i + m - 1) % m], b = idx[i], c = idx[(i + 1) % m];
+      double turn = cross(poly[a], poly[b], poly[c]);
+      if (std::fabs(turn) <= kConvexEpsilon) {
+        // Collinear vertex (or zero-width spike), drop it without a triangle
+        idx.erase(idx.begin() + i);
+        clipped = true;
+        break;
+      }
+      if (turn < 0)
+        continue; // Reflex vertex can't be an ear tip
+
+      // An ear must not contain any other remaining vertex. Only reflex
+      // vertices can lie inside it, but the full scan keeps this simple.
+      bool contains = false;
+      for (size_t k : idx) {
+        if (k == a || k == b || k == c)
+          continue;
+        const ClipperLib::FPoint& p = poly[k];
+        if (cross(poly[a], poly[b], p) >= 0 &&
+            cross(poly[b], poly[c], p) >= 0 &&
+            cross(poly[c], poly[a], p) >= 0) {
+          contains = true;
+          break;
+        }
+      }
+      if (contains)
+        continue;
+
+      tris.push_back({ a, b, c });
+      idx.erase(idx.begin() + i);
+      clipped = true;
+      break;
+    }
+    if (!clipped)
+      return false;
+  }
+  if (idx.size() == 3 &&
+      cross(poly[idx[0]], poly[idx[1]], poly[idx[2]]) > kConvexEpsilon)
+    tris.push_back({ idx[0], idx[1], idx[2] });
+  return !tris.empty();
+}
+
+// Merge two convex pieces across their shared diagonal u-v. On success `out`
+// holds the merged CCW loop; it's only accepted by the caller if convex.
+static bool mergeAcross(const std::vector<size_t>& P,
+                        const std::vector<size_t>& Q,
+                        size_t                     u,
+                        size_t                     v,
+                        std::vector<size_t>&       out)
+{
+  auto find_edge = [](const std::vector<size_t>& loop, size_t a, size_t b) {
+    for (size_t i = 0; i < loop.size(); i++)
+      if (loop[i] == a && loop[(i + 1) % loop.size()] == b)
+        return i;
+    return std::numeric_limits<size_t>::max();
+  };
+  constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  size_t ip = find_edge(P, u, v);
+  if (ip == npos) {
+    std::swap(u, v);
+    ip = find_edge(P, u, v);
+  }
+  size_t iq = find_edge(Q, v, u);
+  if (ip == npos || iq == npos)
+    return false;
+
+  // Walk P from v round to u, then Q from after u to just before v
+  out.clear();
+  for (size_t k = 0; k < P.size(); k++)
+    out.push_back(P[(ip + 1 + k) % P.size()]);
+  for (size_t k = 0; k + 2 < Q.size(); k++)
+    out.push_back(Q[(iq + 2 + k) % Q.size()]);
+  return true;
+}
+
+// Split a simple polygon into convex CCW pieces: ear-clipping triangulation
+// followed by Hertel-Mehlhorn removal of inessential diagonals, which yields
+// at most four times the optimal number of pieces.
+static ClipperLib::Paths convexDecompose(ClipperLib::Path poly)
+{
+  if (poly.size() < 3)
+    return {};
+  if (!ClipperLib::Orientation(poly))
+    ClipperLib::ReversePath(poly); // Ensure CCW
+  if (isConvex(poly))
+    return { poly };
+
+  std::vector<std::array<size_t, 3>> tris;
+  if (poly.size() > kMaxExactNfpVertices || !triangulate(poly, tris))
+    return { convexHull(poly) };
+
+  std::vector<std::vector<size_t>> pieces;
+  std::vector<size_t>              parent(tris.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  for (const auto& t : tris)
+    pieces.push_back({ t[0], t[1], t[2] });
+
+  auto find_root = [&parent](size_t i) {
+    while (parent[i] != i)
+      i = parent[i] = parent[parent[i]];
+    return i;
+  };
+
+  // Diagonals are the triangle edges shared by two triangles
+  std::map<std::pair<size_t, size_t>, std::vector<size_t>> edge_owners;
+  for (size_t t = 0; t < tris.size(); t++) {
+    for (size_t e = 0; e < 3; e++) {
+      size_t u = tris[t][e], v = tris[t][(e + 1) % 3];
+      edge_owners[{ std::min(u, v), std::max(u, v) }].push_back(t);
+    }
+  }
+
+  std::vector<size_t> merged;
+  for (const auto& [edge, owners] : edge_owners) {
+    if (owners.size() != 2)
+      continue; // Polygon boundary edge
+    size_t p = find_root(owners[0]);
+    size_t q = find_root(owners[1]);
+    if (p == q)
+      continue;
+    if (mergeAcross(pieces[p], pieces[q], edge.first, edge.second, merged) &&
+        isConvexLoop(merged, poly)) {
+      pieces[p] = merged;
+      pieces[q].clear();
+      parent[q] = p;
+    }
+  }
+
+  ClipperLib::Paths result;
+  for (const auto& piece : pieces) {
+    if (piece.size() < 3)
+      continue;
+    ClipperLib::Path path;
+    path.reserve(piece.size());
+    for (size_t i : piece)
+      path.push_back(poly[i]);
+    result.push_back(std::move(path));
+  }
+  return result;
+}
+
+// Hash of a contour's geometry quantized to 1 um, so the same part shape maps
+// to the same NFP cache entries in every run and session. NFPs are relative
+// to the part origin, so the hash is deliberately not translation invariant.
+// A non-zero `seed` keeps other cached regions (hole inner-fits) apart from
+// NFPs of the same geometry.
+static uint64_t contourHash(const ClipperLib::Path& contour, uint64_t seed = 0)
+{
+  auto mix = [](uint64_t h, uint64_t v) {
+    h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 27);
+  };
+  uint64_t h = mix(seed, contour.size());
+  for (const auto& pt : contour) {
+    h = mix(h, static_cast<uint64_t>(std::llround(pt.X * 1000.0)));
+    h = mix(h, static_cast<uint64_t>(std::llround(pt.Y * 1000.0)));
+  }
+  return h;
+}
+
+// Confirms a hash match: same vertex count and every vertex within `tolerance`
+static bool contoursMatch(const ClipperLib::Path& a,
+                          const ClipperLib::Path& b,
+                          double                  tolerance = 1e-3)
+{
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (std::fabs(a[i].X - b[i].X) > tolerance ||
+        std::fabs(a[i].Y - b[i].Y) > tolerance)
+      return false;
+  }
+  return true;
+}
+
+// Even-odd ray cast, as checkIfPointIsInsidePath() but on Clipper paths
+static bool pointInPath(const ClipperLib::FPoint& point,
+                        const ClipperLib::Path&   path)
+{
+  bool inside = false;
+  for (size_t i = 0, j = path.size() - 1; i < path.size(); j = i++) {
+    if ((path[i].Y < point.Y) != (path[j].Y < point.Y) &&
+        point.X < path[i].X + (point.Y - path[i].Y) /
+                                (path[j].Y - path[i].Y) *
+                                (path[j].X - path[i].X))
+      inside = !inside;
+  }
+  return inside;
+}
+
+std::vector<PolyNest::HoleRegion>
+PolyNest::PolyNest::getBaseHoles(const PolyPart& part, double min_area) const
+{
+  // Only plain holes qualify: contained by the outside contour alone and
+  // containing no island, whose material the hole region would otherwise
+  // include
+  std::vector<HoleRegion> holes;
+  for (size_t i = 0; i + 1 < part.m_polygons.size(); i++) {
+    const PolyGon& polygon = part.m_polygons[i];
+    if (!polygon.m_is_inside || polygon.m_vertices.size() < 3)
+      continue;
+    bool plain = true;
+    for (size_t j = 0; j + 1 < part.m_polygons.size() && plain; j++) {
+      const ClipperLib::Path& other = part.m_polygons[j].m_vertices;
+      if (j == i || other.empty())
+        continue;
+      // Inside each other one way or the other means nested contours
+      plain = !pointInPath(other.front(), polygon.m_vertices) &&
+              !pointInPath(polygon.m_vertices.front(), other);
+    }
+    if (!plain)
+      continue;
+
+    HoleRegion hole;
+    hole.contour = polygon.m_vertices;
+    ClipperLib::CleanPolygon(hole.contour, 1.0);
+    if (hole.contour.size() < 3)
+      continue;
+    if (!ClipperLib::Orientation(hole.contour))
+      ClipperLib::ReversePath(hole.contour);
+    hole.area = ClipperLib::Area(hole.contour);
+    if (hole.area < min_area)
+      continue;
+    hole.hash = contourHash(hole.contour, 1);
+    holes.push_back(std::move(hole));
+  }
+  return holes;
+}
+
 ClipperLib::Paths
-PolyNest::PolyNest::computeNfp(const ClipperLib::Path& stationary,
-                               const ClipperLib::Path& orbiting)
+PolyNest::PolyNest::decomposeContour(const ClipperLib::Path& contour)
 {
-  // NFP(A, B) = MinkowskiSum(convexHull(A), convexHull(reflect(B)))
-  // Using convex hulls with our own Minkowski sum avoids Clipper 6.1.3's
-  // MinkowskiSum crash (null pointer in IntersectEdges due to degenerate
-  // quads). Convex hull is conservative for concave parts (slightly larger
-  // forbidden region = slightly less tight packing) but guarantees no overlap.
-  ClipperLib::Path hullA = convexHull(stationary);
-  if (!ClipperLib::Orientation(hullA))
-    ClipperLib::ReversePath(hullA); // Ensure CCW
-
-  ClipperLib::Path reflected = reflectPolygon(orbiting);
-  ClipperLib::Path hullB = convexHull(reflected);
-  if (!ClipperLib::Orientation(hullB))
-    ClipperLib::ReversePath(hullB); // Ensure CCW
-
-  if (hullA.size() < 3 || hullB.size() < 3)
+  if (contour.size() < 3)
     return {};
+  if (m_nfp_mode == NfpMode::Exact)
+    return convexDecompose(contour);
 
-  ClipperLib::Path nfp = convexMinkowskiSum(hullA, hullB);
-  if (nfp.size() < 3)
+  ClipperLib::Path hull = convexHull(contour);
+  if (!ClipperLib::Orientation(hull))
+    ClipperLib::ReversePath(hull); // Ensure CCW
+  if (hull.size() < 3)
     return {};
+  return { hull };
+}
 
-  return { nfp };
+ClipperLib::Paths
+PolyNest::PolyNest::computeNfp(const ClipperLib::Paths& stationary,
+                               const ClipperLib::Paths& orbiting)
+{
+  // NFP(A, B) = A (+) reflect(B). Minkowski sums distribute over union, so
+  // with A and B given as convex pieces the NFP is the union of the pairwise
+  // convex sums. Using our own convex Minkowski sum avoids Clipper 6.1.3's
+  // MinkowskiSum crash (null pointer in IntersectEdges due to degenerate
+  // quads). Point reflection keeps the pieces CCW, as the sum requires.
+  ClipperLib::Paths sums;
+  sums.reserve(stationary.size() * orbiting.size());
+  for (const auto& orb_piece : orbiting) {
+    ClipperLib::Path reflected = reflectPolygon(orb_piece);
+    for (const auto& stat_piece : stationary) {
+      ClipperLib::Path sum = convexMinkowskiSum(stat_piece, reflected);
+      if (sum.size() >= 3)
+        sums.push_back(std::move(sum));
+    }
+  }
+  if (sums.size() <= 1)
+    return sums;
+
+  // One batched union; the result keeps interior holes (CW paths) where the
+  // orbiting part fits inside a concavity of the stationary one.
+  ClipperLib::Clipper c;
+  c.AddPaths(sums, ClipperLib::ptSubject, true);
+  ClipperLib::Paths nfp;
+  c.Execute(
+    ClipperLib::ctUnion, nfp, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+  return nfp;
 }
 
 ClipperLib::Paths
-PolyNest::PolyNest::computeIfp(const ClipperLib::Path& part_contour)
+PolyNest::PolyNest::computeIfp(const ClipperLib::Path& part_contour,
+                               size_t                  contour_idx,
+                               double                  angle)
 {
   // IFP = the set of reference points where the ENTIRE part fits inside
-  // the material rectangle (Minkowski erosion of material by part).
-  //
+  // the material (Minkowski erosion of material by part).
+  if (part_contour.empty())
+    return {};
+
+  // Irregular material: the general erosion, computed once per shape and
+  // rotation and moved onto the current sheet
+  if (!m_material_outline.empty()) {
+    NfpCache::Entry ifp = getMaterialIfpCached(contour_idx, angle);
+    double          dx = m_min_extents.x - m_material_min.x;
+    double          dy = m_min_extents.y - m_material_min.y;
+    if (dx == 0 && dy == 0)
+      return *ifp;
+    return translatePaths(*ifp, dx, dy);
+  }
+
   // For rectangular material, this has a simple closed form:
   //   IFP = [mat_min_x - min(part_x), mat_max_x - max(part_x)]
   //       x [mat_min_y - min(part_y), mat_max_y - max(part_y)]
-  if (part_contour.empty())
-    return {};
 
   double part_min_x = std::numeric_limits<double>::infinity();
   double part_max_x = -std::numeric_limits<double>::infinity();
@@ -410,24 +1026,156 @@ PolyNest::PolyNest::computeIfp(const ClipperLib::Path& part_contour)
   return { ifp_rect };
 }
 
-const ClipperLib::Paths& PolyNest::PolyNest::getNfpCached(size_t stat_idx,
-                                                          double stat_angle,
-                                                          size_t orb_idx,
-                                                          double orb_angle)
+// Inner-fit polygon of an arbitrary simple `region` for a part given by its
+// convex `pieces`: the translations that put the whole part inside the
+// region. A translation is feasible iff the part touches no boundary edge and
+// one of its points lies inside, so the IFP is the region shifted by a part
+// vertex minus every boundary edge swept by the reflected pieces. Each swept
+// edge is convex (a segment plus a convex piece), so no general Minkowski sum
+// is needed.
+static ClipperLib::Paths innerFitPolygon(ClipperLib::Path         region,
+                                         const ClipperLib::Paths& pieces)
+{
+  if (region.size() < 3 || pieces.empty() || pieces.front().empty())
+    return {};
+  if (!ClipperLib::Orientation(region))
+    ClipperLib::ReversePath(region);
+
+  const ClipperLib::FPoint ref = pieces.front().front();
+  ClipperLib::Path         shifted;
+  shifted.reserve(region.size());
+  for (const auto& pt : region) {
+    shifted.push_back(ClipperLib::FPoint(snapToGrid(pt.X - ref.X),
+                                         snapToGrid(pt.Y - ref.Y)));
+  }
+
+  ClipperLib::Paths swept;
+  swept.reserve(region.size() * pieces.size());
+  for (const auto& piece : pieces) {
+    for (size_t i = 0; i < region.size(); i++) {
+      const ClipperLib::FPoint& a = region[i];
+      const ClipperLib::FPoint& b = region[(i + 1) % region.size()];
+      ClipperLib::Path          points;
+      points.reserve(piece.size() * 2);
+      for (const auto& pt : piece) {
+        points.push_back(ClipperLib::FPoint(snapToGrid(a.X - pt.X),
+                                            snapToGrid(a.Y - pt.Y)));
+        points.push_back(ClipperLib::FPoint(snapToGrid(b.X - pt.X),
+                                            snapToGrid(b.Y - pt.Y)));
+      }
+      ClipperLib::Path hull = convexHull(std::move(points));
+      if (hull.size() >= 3)
+        swept.push_back(std::move(hull));
+    }
+  }
+
+  ClipperLib::Clipper c;
+  c.AddPath(shifted, ClipperLib::ptSubject, true);
+  c.AddPaths(swept, ClipperLib::ptClip, true);
+  ClipperLib::Paths ifp;
+  c.Execute(ClipperLib::ctDifference,
+            ifp,
+            ClipperLib::pftNonZero,
+            ClipperLib::pftNonZero);
+  return ifp;
+}
+
+NfpCache::Entry PolyNest::PolyNest::getNfpCached(size_t stat_idx,
+                                                 double stat_angle,
+                                                 size_t orb_idx,
+                                                 double orb_angle)
+{
+  NfpKey key{ m_base_hashes[stat_idx],
+              m_base_hashes[orb_idx],
+              stat_angle,
+              orb_angle,
+              m_nfp_mode };
+  if (NfpCache::Entry hit = m_nfp_cache->find(key))
+    return hit;
+
+  // Compute and cache from the convex pieces of the base contours
+  auto              start = std::chrono::steady_clock::now();
+  ClipperLib::Paths stat_pieces;
+  for (const auto& piece : m_base_pieces[stat_idx])
+    stat_pieces.push_back(rotatePolygon(piece, stat_angle));
+  ClipperLib::Paths orb_pieces;
+  for (const auto& piece : m_base_pieces[orb_idx])
+    orb_pieces.push_back(rotatePolygon(piece, orb_angle));
+
+  // Computed outside the lock; if two workers race on the same key the first
+  // insert wins and both return the same entry
+  NfpCache::Entry cached =
+    m_nfp_cache->insert(key, computeNfp(stat_pieces, orb_pieces));
+  m_nfp_cache->recordCompute(std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+  return cached;
+}
+
+NfpCache::Entry PolyNest::PolyNest::getHoleIfpCached(size_t owner_idx,
+                                                     size_t hole,
+                                                     double owner_angle,
+                                                     size_t orb_idx,
+                                                     double orb_angle)
 {
-  NfpKey key{ stat_idx, orb_idx, stat_angle, orb_angle };
-  auto   it = m_nfp_cache.find(key);
-  if (it != m_nfp_cache.end())
-    return it->second;
+  const HoleRegion& region = m_base_holes[owner_idx][hole];
+  NfpKey            key{
+    region.hash, m_base_hashes[orb_idx], owner_angle, orb_angle, m_nfp_mode
+  };
+  if (NfpCache::Entry hit = m_nfp_cache->find(key))
+    return hit;
+
+  auto              start = std::chrono::steady_clock::now();
+  ClipperLib::Paths orb_pieces;
+  for (const auto& piece : m_base_pieces[orb_idx])
+    orb_pieces.push_back(rotatePolygon(piece, orb_angle));
+  NfpCache::Entry cached = m_nfp_cache->insert(
+    key,
+    innerFitPolygon(rotatePolygon(region.contour, owner_angle), orb_pieces));
+  m_nfp_cache->recordCompute(std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+  return cached;
+}
 
-  // Compute and cache using the unified base contour array
-  ClipperLib::Path stat_contour =
-    rotatePolygon(m_base_contours[stat_idx], stat_angle);
-  ClipperLib::Path orb_contour =
-    rotatePolygon(m_base_contours[orb_idx], orb_angle);
+NfpCache::Entry PolyNest::PolyNest::getMaterialIfpCached(size_t orb_idx,
+                                                         double orb_angle)
+{
+  NfpKey key{
+    m_material_hash, m_base_hashes[orb_idx], 0.0, orb_angle, m_nfp_mode
+  };
+  if (NfpCache::Entry hit = m_nfp_cache->find(key))
+    return hit;
+
+  auto              start = std::chrono::steady_clock::now();
+  ClipperLib::Paths orb_pieces;
+  for (const auto& piece : m_base_pieces[orb_idx])
+    orb_pieces.push_back(rotatePolygon(piece, orb_angle));
+
+  // Erode the outline, then remove every position where the part would
+  // overlap a hole: exactly the NFP of the hole against the part
+  ClipperLib::Paths ifp = innerFitPolygon(m_material_outline, orb_pieces);
+  if (!ifp.empty() && !m_material_holes.empty()) {
+    ClipperLib::Paths blocked;
+    for (const auto& hole : m_material_holes) {
+      for (auto& path : computeNfp(decomposeContour(hole), orb_pieces))
+        blocked.push_back(std::move(path));
+    }
+    ClipperLib::Clipper c;
+    c.AddPaths(ifp, ClipperLib::ptSubject, true);
+    c.AddPaths(translatePaths(blocked, 0, 0), ClipperLib::ptClip, true);
+    ClipperLib::Paths remaining;
+    c.Execute(ClipperLib::ctDifference,
+              remaining,
+              ClipperLib::pftNonZero,
+              ClipperLib::pftNonZero);
+    ifp = std::move(remaining);
+  }
 
-  auto& cached = m_nfp_cache[key];
-  cached = computeNfp(stat_contour, orb_contour);
+  NfpCache::Entry cached = m_nfp_cache->insert(key, std::move(ifp));
+  m_nfp_cache->recordCompute(std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
   return cached;
 }
 
@@ -438,9 +1186,11 @@ void PolyNest::PolyNest::pushUnplacedPolyPart(
   double*                             offset_x,
   double*                             offset_y,
   double*                             angle,
-  bool*                               visible)
+  bool*                               visible,
+  RotationMode                        rotation)
 {
   PolyPart part = buildPart(p, offset_x, offset_y, angle, visible);
+  part.m_rotation = rotation;
   m_unplaced_parts.push_back(part);
 }
 
@@ -455,28 +1205,198 @@ void PolyNest::PolyNest::pushPlacedPolyPart(
   m_placed_parts.push_back(part);
 }
 
+void PolyNest::PolyNest::setThreadCount(unsigned threads)
+{
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  m_thread_count = std::max(1u, threads);
+}
+
+void PolyNest::PolyNest::setRotationStep(double degrees)
+{
+  // Right angles have to stay reachable, so the step divides 90
+  int divisions = std::clamp(
+    static_cast<int>(std::lround(90.0 / std::max(degrees, 1.0))), 1, 90);
+  while (90 % divisions != 0)
+    divisions++;
+  m_rotation_step = 90.0 / divisions;
+  m_allowed_rotations.clear();
+  for (int i = 0; i < 4 * divisions; i++)
+    m_allowed_rotations.push_back(i * m_rotation_step);
+}
+
 void PolyNest::PolyNest::setExtents(PolyPoint min, PolyPoint max)
 {
   m_min_extents = min;
   m_max_extents = max;
+  m_material_outline.clear();
+  m_material_holes.clear();
+  m_material_hash = 0;
+}
+
+void PolyNest::PolyNest::setMaterial(
+  const std::vector<std::vector<PolyPoint>>& contours)
+{
+  auto toPath = [](const std::vector<PolyPoint>& points) {
+    ClipperLib::Path path;
+    for (const auto& p : points)
+      path.push_back(ClipperLib::FPoint(snapToGrid(p.x), snapToGrid(p.y)));
+    ClipperLib::CleanPolygon(path, 0.01);
+    if (path.size() >= 3 && !ClipperLib::Orientation(path))
+      ClipperLib::ReversePath(path);
+    return path;
+  };
+  if (contours.empty() || contours.front().size() < 3) {
+    LOG_F(WARNING, "Material outline needs at least 3 points, ignored");
+    return;
+  }
+  ClipperLib::Path outline = toPath(contours.front());
+  if (outline.size() < 3)
+    return;
+
+  Bounds bounds;
+  bounds.extend(outline);
+  m_min_extents = PolyPoint(bounds.min_x, bounds.min_y);
+  m_max_extents = PolyPoint(bounds.max_x, bounds.max_y);
+  m_material_min = m_min_extents;
+  m_material_outline = std::move(outline);
+  m_material_holes.clear();
+  m_material_hash = contourHash(m_material_outline, 2);
+  for (size_t i = 1; i < contours.size(); i++) {
+    ClipperLib::Path hole = toPath(contours[i]);
+    if (hole.size() < 3)
+      continue;
+    m_material_hash = contourHash(hole, m_material_hash);
+    m_material_holes.push_back(std::move(hole));
+  }
+}
+
+std::vector<std::vector<PolyPoint>>
+PolyNest::PolyNest::computeRemnant(double min_width) const
+{
+  ClipperLib::Paths material;
+  if (m_material_outline.empty()) {
+    material.push_back({ ClipperLib::FPoint(m_min_extents.x, m_min_extents.y),
+                         ClipperLib::FPoint(m_max_extents.x, m_min_extents.y),
+                         ClipperLib::FPoint(m_max_extents.x, m_max_extents.y),
+                         ClipperLib::FPoint(m_min_extents.x,
+                                            m_max_extents.y) });
+  }
+  else {
+    material.push_back(m_material_outline);
+  }
+
+  // Parts count as solid: whatever drops out of their holes is scrap. The
+  // built outlines already carry the part spacing.
+  ClipperLib::Paths used = m_material_holes;
+  for (const auto& part : m_placed_parts) {
+    if (part.m_built_polygons.empty())
+      continue;
+    ClipperLib::Path outline = part.m_built_polygons.back().m_vertices;
+    if (outline.size() < 3)
+      continue;
+    if (!ClipperLib::Orientation(outline))
+      ClipperLib::ReversePath(outline);
+    used.push_back(std::move(outline));
+  }
+
+  ClipperLib::Clipper c;
+  c.AddPaths(translatePaths(material, 0, 0), ClipperLib::ptSubject, true);
+  c.AddPaths(translatePaths(used, 0, 0), ClipperLib::ptClip, true);
+  ClipperLib::Paths remainder;
+  c.Execute(ClipperLib::ctDifference,
+            remainder,
+            ClipperLib::pftNonZero,
+            ClipperLib::pftNonZero);
+
+  // Morphological opening: anything narrower than min_width vanishes on the
+  // way in and doesn't come back on the way out
+  ClipperLib::Paths opened = remainder;
+  if (min_width > 0) {
+    ClipperLib::ClipperOffset shrink;
+    ClipperLib::Paths         eroded;
+    shrink.AddPaths(
+      remainder, ClipperLib::jtMiter, ClipperLib::etClosedPolygon);
+    shrink.Execute(eroded, -0.5 * min_width);
+    ClipperLib::ClipperOffset grow;
+    grow.AddPaths(eroded, ClipperLib::jtMiter, ClipperLib::etClosedPolygon);
+    opened.clear();
+    grow.Execute(opened, 0.5 * min_width);
+  }
+
+  // Clip back to the remainder (mitred corners can overshoot) and sort the
+  // regions into outlines and holes
+  ClipperLib::Clipper clip;
+  clip.AddPaths(translatePaths(opened, 0, 0), ClipperLib::ptSubject, true);
+  clip.AddPaths(translatePaths(remainder, 0, 0), ClipperLib::ptClip, true);
+  ClipperLib::PolyTree tree;
+  clip.Execute(ClipperLib::ctIntersection,
+               tree,
+               ClipperLib::pftNonZero,
+               ClipperLib::pftNonZero);
+
+  const ClipperLib::PolyNode* best = nullptr;
+  double                      best_area = 0;
+  for (const ClipperLib::PolyNode* region : tree.Childs) {
+    double area = std::fabs(ClipperLib::Area(region->Contour));
+    for (const ClipperLib::PolyNode* hole : region->Childs)
+      area -= std::fabs(ClipperLib::Area(hole->Contour));
+    if (area > best_area) {
+      best_area = area;
+      best = region;
+    }
+  }
+  if (!best)
+    return {};
+
+  auto toPoints = [](const ClipperLib::Path& path) {
+    std::vector<PolyPoint> points;
+    points.reserve(path.size());
+    for (const auto& pt : path)
+      points.push_back(PolyPoint(pt.X, pt.Y));
+    return points;
+  };
+  std::vector<std::vector<PolyPoint>> remnant;
+  remnant.push_back(toPoints(best->Contour));
+  for (const ClipperLib::PolyNode* hole : best->Childs)
+    remnant.push_back(toPoints(hole->Contour));
+  return remnant;
 }
 
 void PolyNest::PolyNest::beginPlaceUnplacedPolyParts()
+{
+  m_control->stop = false;
+  {
+    std::lock_guard lock(m_control->mutex);
+    m_control->best.clear();
+    m_control->finished.clear();
+  }
+  m_nfp_cache->resetCounters();
+  m_stats = NestStats{};
+  m_counters = std::make_unique<NestCounters>();
+  prepareBaseContours();
+}
+
+void PolyNest::PolyNest::prepareBaseContours()
 {
   // Build unified base contour array:
   //   indices [0, F) = fixed (placed) parts
   //   indices [F, F+N) = unplaced parts
   m_base_contours.clear();
+  m_base_pieces.clear();
+  m_base_hashes.clear();
+  m_canonical_ids.clear();
+  m_base_holes.clear();
+  m_part_areas.clear();
   m_fixed_placed.clear();
-  m_nfp_cache.clear();
 
   // Record already-placed parts as fixed obstacles
   for (size_t i = 0; i < m_placed_parts.size(); i++) {
     FixedPart fp;
     fp.part_idx = m_base_contours.size(); // index into m_base_contours
-    fp.angle = *m_placed_parts[i].m_angle;
-    fp.x = *m_placed_parts[i].m_offset_x;
-    fp.y = *m_placed_parts[i].m_offset_y;
+    fp.angle = m_placed_parts[i].m_start_angle;
+    fp.x = m_placed_parts[i].m_start_x;
+    fp.y = m_placed_parts[i].m_start_y;
     fp.contour = getBaseContour(m_placed_parts[i]);
     m_fixed_placed.push_back(fp);
     m_base_contours.push_back(fp.contour);
@@ -497,6 +1417,68 @@ void PolyNest::PolyNest::beginPlaceUnplacedPolyParts()
   for (size_t i = 0; i < m_unplaced_parts.size(); i++) {
     m_base_contours.push_back(getBaseContour(m_unplaced_parts[i]));
   }
+
+  // Holes smaller than the smallest unplaced part can never take one
+  double min_part_area = std::numeric_limits<double>::infinity();
+  for (size_t i = m_num_fixed_contours; i < m_base_contours.size(); i++) {
+    m_part_areas.push_back(std::fabs(ClipperLib::Area(m_base_contours[i])));
+    min_part_area = std::min(min_part_area, m_part_areas.back());
+  }
+  size_t hole_count = 0;
+  for (size_t i = 0; i < m_base_contours.size(); i++) {
+    const PolyPart& part = i < m_num_fixed_contours
+                             ? m_placed_parts[i]
+                             : m_unplaced_parts[i - m_num_fixed_contours];
+    m_base_holes.push_back(m_part_in_part
+                             ? getBaseHoles(part, min_part_area)
+                             : std::vector<HoleRegion>{});
+    hole_count += m_base_holes.back().size();
+  }
+
+  // Deduplicate identical contours (duplicated parts, multi-quantity jobs)
+  // so each distinct shape is decomposed once and its NFPs are shared
+  auto holesMatch = [](const std::vector<HoleRegion>& a,
+                       const std::vector<HoleRegion>& b) {
+    if (a.size() != b.size())
+      return false;
+    for (size_t h = 0; h < a.size(); h++) {
+      if (a[h].hash != b[h].hash || !contoursMatch(a[h].contour, b[h].contour))
+        return false;
+    }
+    return true;
+  };
+  std::unordered_map<uint64_t, std::vector<size_t>> by_hash;
+  size_t                                            distinct = 0;
+  for (size_t i = 0; i < m_base_contours.size(); i++) {
+    const ClipperLib::Path& contour = m_base_contours[i];
+    uint64_t                hash = contourHash(contour);
+    size_t                  canonical = i;
+    for (size_t other : by_hash[hash]) {
+      if (contoursMatch(m_base_contours[other], contour) &&
+          holesMatch(m_base_holes[other], m_base_holes[i])) {
+        canonical = other;
+        break;
+      }
+    }
+    m_base_hashes.push_back(hash);
+    m_canonical_ids.push_back(canonical);
+    if (canonical == i) {
+      by_hash[hash].push_back(i);
+      m_base_pieces.push_back(decomposeContour(contour));
+      distinct++;
+    }
+    else {
+      m_base_pieces.push_back(m_base_pieces[canonical]);
+    }
+  }
+  m_stats.distinct_shapes = distinct;
+  LOG_F(INFO,
+        "Nesting %zu contours (%zu distinct shapes, %zu usable holes)",
+        m_base_contours.size(),
+        distinct,
+        hole_count);
+  if (m_evaluator == NestEvaluator::Raster)
+    prepareRasterSheet();
 }
 
 // ---------- Bottom-Left Fill ----------
@@ -518,104 +1500,326 @@ PolyNest::PolyNest::findBottomLeftPoint(const ClipperLib::Paths& feasible)
   return best;
 }
 
-NestingSolution PolyNest::runBLF(const std::vector<size_t>& order,
-                                 const std::vector<double>& angles)
+PolyNest::PolyNest::PlacedIndex::PlacedIndex(double min_y, double max_y)
+  : m_min_y(min_y),
+    m_row_height(std::max(max_y - min_y, 1.0) / kRows),
+    m_rows(kRows)
 {
-  const size_t    n = m_unplaced_parts.size();
-  NestingSolution sol;
-  sol.part_order = order;
-  sol.part_angles = angles;
-  sol.placed_x.resize(n, 0);
-  sol.placed_y.resize(n, 0);
-  sol.placed_ok.resize(n, false);
-  sol.parts_placed = 0;
-  sol.bounding_width = 0;
+}
 
-  // Track placements: contour index + position
-  struct PlacedEntry {
-    size_t contour_idx; // index into m_base_contours
-    double angle;
-    double x, y;
-  };
-  std::vector<PlacedEntry> placed;
-
-  // Include fixed (pre-placed) parts as obstacles
-  for (const auto& fp : m_fixed_placed) {
-    placed.push_back({ fp.part_idx, fp.angle, fp.x, fp.y });
-  }
-
-  for (size_t idx : order) {
-    double           angle = angles[idx];
-    size_t           contour_idx = m_num_fixed_contours + idx;
-    ClipperLib::Path rotated =
-      rotatePolygon(m_base_contours[contour_idx], angle);
-
-    // 1. Compute IFP (where part fits inside material)
-    ClipperLib::Paths ifp = computeIfp(rotated);
-    if (ifp.empty())
-      continue;
-
-    // 2. Compute NFPs against all placed parts and union them
-    ClipperLib::Paths nfp_union;
-    bool              has_obstacles = false;
+size_t PolyNest::PolyNest::PlacedIndex::row(double y) const
+{
+  // Parts and queries past the sheet edges go to the outer rows
+  const double r = std::floor((y - m_min_y) / m_row_height);
+  return static_cast<size_t>(
+    std::clamp(r, 0.0, static_cast<double>(kRows - 1)));
+}
 
-    for (const auto& pe : placed) {
-      // Look up or compute NFP (cached by contour index + angles)
-      const ClipperLib::Paths& nfp_base =
-        getNfpCached(pe.contour_idx, pe.angle, contour_idx, angle);
+void PolyNest::PolyNest::PlacedIndex::add(const PlacedEntry& entry)
+{
+  const size_t index = m_entries.size();
+  m_entries.push_back(entry);
+  m_seen.push_back(0);
+  for (size_t r = row(entry.bounds.min_y); r <= row(entry.bounds.max_y); r++)
+    m_rows[r].push_back(index);
+}
 
-      if (nfp_base.empty())
+void PolyNest::PolyNest::PlacedIndex::query(const Bounds&        box,
+                                            std::vector<size_t>& out)
+{
+  out.clear();
+  m_query++;
+  for (size_t r = row(box.min_y); r <= row(box.max_y); r++) {
+    for (size_t index : m_rows[r]) {
+      if (m_seen[index] == m_query)
         continue;
+      m_seen[index] = m_query;
+      if (m_entries[index].bounds.overlaps(box))
+        out.push_back(index);
+    }
+  }
+  std::sort(out.begin(), out.end());
+}
 
-      // Translate NFP to placed part's position
-      ClipperLib::Paths nfp_translated;
-      nfp_translated.reserve(nfp_base.size());
-      for (const auto& nfp_path : nfp_base) {
-        ClipperLib::Path translated;
-        translated.reserve(nfp_path.size());
-        for (const auto& pt : nfp_path) {
-          translated.push_back(ClipperLib::FPoint(pt.X + pe.x, pt.Y + pe.y));
-        }
-        nfp_translated.push_back(std::move(translated));
-      }
+// Bounds of the obstacles whose NFP can reach `box` for a part of bounds
+// `part`, the inverse of nfpBounds()
+static Bounds obstacleBounds(const Bounds& box, const Bounds& part)
+{
+  Bounds obstacles;
+  obstacles.min_x = box.min_x + part.min_x;
+  obstacles.max_x = box.max_x + part.max_x;
+  obstacles.min_y = box.min_y + part.min_y;
+  obstacles.max_y = box.max_y + part.max_y;
+  return obstacles;
+}
 
-      has_obstacles = true;
-      if (nfp_union.empty()) {
-        nfp_union = std::move(nfp_translated);
-      }
-      else {
-        ClipperLib::Clipper c;
-        c.AddPaths(nfp_union, ClipperLib::ptSubject, true);
-        c.AddPaths(nfp_translated, ClipperLib::ptClip, true);
-        ClipperLib::Paths merged;
-        c.Execute(ClipperLib::ctUnion,
-                  merged,
-                  ClipperLib::pftNonZero,
-                  ClipperLib::pftNonZero);
-        nfp_union = std::move(merged);
+bool PolyNest::PolyNest::findBottomLeftPlacement(
+  const ClipperLib::Paths& ifp,
+  const ClipperLib::Path&  rotated,
+  size_t                   contour_idx,
+  double                   angle,
+  PlacedIndex&             placed,
+  ClipperLib::FPoint&      bl)
+{
+  ClipperLib::Paths snapped_ifp = translatePaths(ifp, 0, 0);
+
+  Bounds ifp_box;
+  for (const auto& path : snapped_ifp)
+    ifp_box.extend(path);
+  Bounds part_box;
+  part_box.extend(rotated);
+
+  // Sweep the IFP bottom-up in slabs, the first one part-height tall and
+  // each one after twice as tall as the one before. Every point of a slab can
+  // only be covered by NFPs overlapping that slab, so the first slab with any
+  // feasible area holds the bottom-left point and everything above it is
+  // never fetched, translated or clipped. Doubling keeps the number of slabs,
+  // and so the number of times a tall NFP is clipped, logarithmic in the
+  // sheet height. Each slab is a single batched boolean: IFP minus (slab
+  // mask + the NFPs the index finds overlapping it).
+  double       slab_height =
+    snapToGrid(std::max(part_box.max_y - part_box.min_y, 1.0));
+  const double mask_x0 = ifp_box.min_x - 1.0;
+  const double mask_x1 = ifp_box.max_x + 1.0;
+  auto         mask_rect = [&](double y0, double y1) {
+    ClipperLib::Path rect;
+    rect.push_back(ClipperLib::FPoint(mask_x0, y0));
+    rect.push_back(ClipperLib::FPoint(mask_x1, y0));
+    rect.push_back(ClipperLib::FPoint(mask_x1, y1));
+    rect.push_back(ClipperLib::FPoint(mask_x0, y1));
+    return rect; // CCW, same winding as NFP outers
+  };
+
+  // Translated NFPs by entry, fetched on first use
+  std::unordered_map<size_t, ClipperLib::Paths> nfps;
+  std::vector<size_t>                           near;
+  for (double y0 = ifp_box.min_y;; y0 += slab_height, slab_height *= 2) {
+    double y1 = std::min(y0 + slab_height, ifp_box.max_y);
+
+    ClipperLib::Clipper c;
+    c.AddPaths(snapped_ifp, ClipperLib::ptSubject, true);
+    if (y0 > ifp_box.min_y)
+      c.AddPath(
+        mask_rect(ifp_box.min_y - 1.0, y0), ClipperLib::ptClip, true);
+    if (y1 < ifp_box.max_y)
+      c.AddPath(
+        mask_rect(y1, ifp_box.max_y + 1.0), ClipperLib::ptClip, true);
+
+    Bounds slab = ifp_box;
+    slab.min_y = y0;
+    slab.max_y = y1;
+    placed.query(obstacleBounds(slab, part_box), near);
+    for (size_t index : near) {
+      auto [it, inserted] = nfps.try_emplace(index);
+      if (inserted) {
+        const PlacedEntry& pe = placed.entries()[index];
+        NfpCache::Entry    nfp_base =
+          getNfpCached(pe.contour_idx, pe.angle, contour_idx, angle);
+        it->second = translatePaths(*nfp_base, pe.x, pe.y);
       }
+      if (!it->second.empty())
+        c.AddPaths(it->second, ClipperLib::ptClip, true);
     }
 
-    // 3. Feasible region = IFP - NFP_union
     ClipperLib::Paths feasible;
-    if (!has_obstacles) {
-      feasible = ifp;
+    c.Execute(ClipperLib::ctDifference,
+              feasible,
+              ClipperLib::pftNonZero,
+              ClipperLib::pftNonZero);
+    if (!feasible.empty()) {
+      bl = findBottomLeftPoint(feasible);
+      return true;
     }
-    else {
+    if (y1 >= ifp_box.max_y)
+      return false;
+  }
+}
+
+bool PolyNest::PolyNest::findHolePlacement(const ClipperLib::Path& rotated,
+                                           size_t                  contour_idx,
+                                           double                  angle,
+                                           PlacedIndex&            placed,
+                                           ClipperLib::FPoint&     bl)
+{
+  // Bottom-left point over the holes of every placed part. A hole's inner-fit
+  // region lies inside its owner's NFP, so only the other placed parts are
+  // subtracted from it.
+  const double part_area = std::fabs(ClipperLib::Area(rotated));
+  Bounds       part_box;
+  part_box.extend(rotated);
+
+  bool                found = false;
+  std::vector<size_t> near;
+  for (size_t j = 0; j < placed.entries().size(); j++) {
+    const PlacedEntry&             owner = placed.entries()[j];
+    const std::vector<HoleRegion>& holes = m_base_holes[owner.contour_idx];
+    for (size_t h = 0; h < holes.size(); h++) {
+      if (holes[h].area < part_area)
+        continue;
+      // The part sits above the owner's bottom edge in any hole placement
+      if (found && owner.bounds.min_y - part_box.min_y > bl.Y)
+        continue;
+
+      NfpCache::Entry ifp =
+        getHoleIfpCached(owner.contour_idx, h, owner.angle, contour_idx, angle);
+      if (ifp->empty())
+        continue;
+      ClipperLib::Paths region = translatePaths(*ifp, owner.x, owner.y);
+      Bounds            region_box;
+      for (const auto& path : region)
+        region_box.extend(path);
+      if (found && region_box.min_y > bl.Y)
+        continue;
+
       ClipperLib::Clipper c;
-      c.AddPaths(ifp, ClipperLib::ptSubject, true);
-      c.AddPaths(nfp_union, ClipperLib::ptClip, true);
+      c.AddPaths(region, ClipperLib::ptSubject, true);
+      placed.query(obstacleBounds(region_box, part_box), near);
+      for (size_t k : near) {
+        if (k == j)
+          continue;
+        const PlacedEntry& pe = placed.entries()[k];
+        NfpCache::Entry    nfp =
+          getNfpCached(pe.contour_idx, pe.angle, contour_idx, angle);
+        c.AddPaths(translatePaths(*nfp, pe.x, pe.y), ClipperLib::ptClip, true);
+      }
+      ClipperLib::Paths feasible;
       c.Execute(ClipperLib::ctDifference,
                 feasible,
                 ClipperLib::pftNonZero,
                 ClipperLib::pftNonZero);
+      if (feasible.empty())
+        continue;
+
+      ClipperLib::FPoint pt = findBottomLeftPoint(feasible);
+      if (!found || pt.Y < bl.Y || (pt.Y == bl.Y && pt.X < bl.X)) {
+        bl = pt;
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
+NestingSolution
+PolyNest::PolyNest::emptySolution(const std::vector<size_t>& order,
+                                  const std::vector<double>& angles) const
+{
+  const size_t    n = m_unplaced_parts.size();
+  NestingSolution sol;
+  sol.part_order = order;
+  sol.part_angles = angles;
+  sol.placed_x.resize(n, 0);
+  sol.placed_y.resize(n, 0);
+  sol.placed_ok.resize(n, false);
+  sol.step_width.resize(order.size(), 0);
+  sol.parts_placed = 0;
+  sol.bounding_width = 0;
+  return sol;
+}
+
+size_t PolyNest::PolyNest::reusablePrefix(const std::vector<size_t>& order,
+                                          const std::vector<double>& angles,
+                                          const NestingSolution* base) const
+{
+  // BLF is deterministic, so every position before the first one where the
+  // order or a rotation differs from `base` places exactly as it did there.
+  // Identical shapes at the same angle are interchangeable here.
+  if (!base || base->step_width.size() != order.size())
+    return 0;
+  size_t start = 0;
+  while (start < order.size() &&
+         samePlacementInput(order[start],
+                            angles[order[start]],
+                            base->part_order[start],
+                            base->part_angles[base->part_order[start]])) {
+    start++;
+  }
+  return start;
+}
+
+NestingSolution PolyNest::placeParts(const std::vector<size_t>& order,
+                                     const std::vector<double>& angles,
+                                     const NestingSolution*     base)
+{
+  if (m_evaluator == NestEvaluator::Raster)
+    return runRasterBLF(order, angles, base);
+  return runBLF(order, angles, base);
+}
+
+NestingSolution PolyNest::runBLF(const std::vector<size_t>& order,
+                                 const std::vector<double>& angles,
+                                 const NestingSolution*     base)
+{
+  NestingSolution sol = emptySolution(order, angles);
+
+  // Track placements: contour index + position + world bounds
+  PlacedIndex placed(m_min_extents.y, m_max_extents.y);
+  auto place = [&](size_t contour_idx, double angle, double x, double y) {
+    Bounds b;
+    b.extend(rotatePolygon(m_base_contours[contour_idx], angle));
+    b.min_x += x;
+    b.max_x += x;
+    b.min_y += y;
+    b.max_y += y;
+    placed.add({ contour_idx, angle, x, y, b });
+  };
+
+  // Include fixed (pre-placed) parts as obstacles
+  for (const auto& fp : m_fixed_placed) {
+    place(fp.part_idx, fp.angle, fp.x, fp.y);
+  }
+
+  // Copy the prefix shared with `base` instead of recomputing it. (The NFP
+  // union depends on the part being placed, so it can't be carried over
+  // between positions.)
+  size_t start = reusablePrefix(order, angles, base);
+  if (start > 0) {
+    for (size_t k = 0; k < start; k++) {
+      size_t idx = order[k];
+      size_t base_idx = base->part_order[k];
+      sol.step_width[k] = base->step_width[k];
+      if (!base->placed_ok[base_idx])
+        continue;
+      sol.placed_x[idx] = base->placed_x[base_idx];
+      sol.placed_y[idx] = base->placed_y[base_idx];
+      sol.placed_ok[idx] = true;
+      sol.parts_placed++;
+      place(m_num_fixed_contours + idx,
+            angles[idx],
+            base->placed_x[base_idx],
+            base->placed_y[base_idx]);
     }
+    if (start == order.size())
+      sol.bounding_width = base->bounding_width;
+    else
+      sol.bounding_width = base->step_width[start];
+  }
+  m_counters->blf_calls++;
+  m_counters->placements_reused += start;
+  m_counters->placements_computed += order.size() - start;
+
+  for (size_t k = start; k < order.size(); k++) {
+    size_t idx = order[k];
+    sol.step_width[k] = sol.bounding_width;
+
+    double           angle = angles[idx];
+    size_t           contour_idx = m_num_fixed_contours + idx;
+    ClipperLib::Path rotated =
+      rotatePolygon(m_base_contours[contour_idx], angle);
 
-    if (feasible.empty())
+    // 1. Compute IFP (where part fits inside material)
+    ClipperLib::Paths ifp = computeIfp(rotated, contour_idx, angle);
+    if (ifp.empty())
       continue;
 
-    // 4. Find bottom-left point in feasible region
-    ClipperLib::FPoint bl = findBottomLeftPoint(feasible);
+    // 2. Bottom-left point inside a hole of a placed part, which costs no
+    //    sheet length, else of the IFP minus the NFPs of the placed parts
+    ClipperLib::FPoint bl;
+    bool               in_hole =
+      findHolePlacement(rotated, contour_idx, angle, placed, bl);
+    if (!in_hole &&
+        !findBottomLeftPlacement(ifp, rotated, contour_idx, angle, placed, bl))
+      continue;
 
     sol.placed_x[idx] = bl.X;
     sol.placed_y[idx] = bl.Y;
@@ -630,19 +1834,538 @@ NestingSolution PolyNest::runBLF(const std::vector<size_t>& order,
     }
 
     // Add to placed list for subsequent parts
-    placed.push_back({ contour_idx, angle, bl.X, bl.Y });
+    place(contour_idx, angle, bl.X, bl.Y);
   }
 
   return sol;
 }
 
+// ---------- Raster evaluation ----------
+
+ClipperLib::Paths PolyNest::PolyNest::partRegion(size_t contour_idx,
+                                                 double angle) const
+{
+  ClipperLib::Path outline =
+    rotatePolygon(m_base_contours[contour_idx], angle);
+  if (!ClipperLib::Orientation(outline))
+    ClipperLib::ReversePath(outline);
+  ClipperLib::Paths region = { outline };
+  for (const auto& hole : m_base_holes[contour_idx]) {
+    region.push_back(rotatePolygon(hole.contour, angle));
+    ClipperLib::ReversePath(region.back());
+  }
+  return translatePaths(region, 0, 0);
+}
+
+std::shared_ptr<const RasterMask>
+PolyNest::PolyNest::getRasterMask(size_t contour_idx, double angle)
+{
+  // Angles outside the allowed set are rasterized without caching
+  size_t slot = std::find(m_allowed_rotations.begin(),
+                          m_allowed_rotations.end(),
+                          angle) -
+                m_allowed_rotations.begin();
+  size_t canonical = m_canonical_ids[contour_idx];
+  bool   cached = slot < m_allowed_rotations.size();
+  if (cached) {
+    std::shared_lock lock(m_raster_cache->mutex);
+    if (auto mask = m_raster_cache->masks[canonical][slot])
+      return mask;
+  }
+
+  ClipperLib::Paths region = partRegion(contour_idx, angle);
+  Bounds            bounds;
+  bounds.extend(region.front());
+  auto mask = std::make_shared<RasterMask>();
+  mask->origin_x = bounds.min_x;
+  mask->origin_y = bounds.min_y;
+  mask->grid = BitGrid(
+    std::max(1, static_cast<int>(std::ceil(
+                  (bounds.max_x - bounds.min_x) / m_raster_cell))),
+    std::max(1, static_cast<int>(std::ceil(
+                  (bounds.max_y - bounds.min_y) / m_raster_cell))));
+  mask->grid.fillTouched(
+    region, mask->origin_x, mask->origin_y, m_raster_cell);
+  for (int row = 0; row < mask->grid.rows(); row++)
+    mask->widest_run.push_back(mask->grid.widestRun(row));
+  if (!cached)
+    return mask;
+
+  std::unique_lock lock(m_raster_cache->mutex);
+  auto&            entry = m_raster_cache->masks[canonical][slot];
+  if (!entry)
+    entry = std::move(mask);
+  return entry;
+}
+
+void PolyNest::PolyNest::prepareRasterSheet()
+{
+  {
+    std::unique_lock lock(m_raster_cache->mutex);
+    m_raster_cache->masks.assign(
+      m_base_contours.size(),
+      std::vector<std::shared_ptr<const RasterMask>>(
+        m_allowed_rotations.size()));
+  }
+
+  const double cell = m_raster_cell;
+  m_raster_sheet = BitGrid(
+    static_cast<int>(std::floor((m_max_extents.x - m_min_extents.x) / cell)),
+    static_cast<int>(std::floor((m_max_extents.y - m_min_extents.y) / cell)));
+
+  // Cells not entirely inside irregular material count as occupied; every
+  // cell of the extents rectangle is
+  if (!m_material_outline.empty()) {
+    ClipperLib::Paths material = { m_material_outline };
+    for (const auto& hole : m_material_holes) {
+      material.push_back(hole);
+      ClipperLib::ReversePath(material.back());
+    }
+    m_raster_sheet.fillInterior(
+      translatePaths(material,
+                     m_min_extents.x - m_material_min.x,
+                     m_min_extents.y - m_material_min.y),
+      m_min_extents.x,
+      m_min_extents.y,
+      cell);
+    m_raster_sheet.invert();
+  }
+  for (const auto& fp : m_fixed_placed) {
+    m_raster_sheet.fillTouched(
+      translatePaths(partRegion(fp.part_idx, fp.angle), fp.x, fp.y),
+      m_min_extents.x,
+      m_min_extents.y,
+      cell);
+  }
+}
+
+NestingSolution PolyNest::runRasterBLF(const std::vector<size_t>& order,
+                                       const std::vector<double>& angles,
+                                       const NestingSolution*     base)
+{
+  NestingSolution sol = emptySolution(order, angles);
+  BitGrid         sheet = m_raster_sheet;
+  const double    cell = m_raster_cell;
+
+  // Raster placements sit on whole cells, so a copied one stamps back exactly
+  size_t start = reusablePrefix(order, angles, base);
+  for (size_t k = 0; k < start; k++) {
+    size_t idx = order[k];
+    size_t base_idx = base->part_order[k];
+    sol.step_width[k] = base->step_width[k];
+    if (!base->placed_ok[base_idx])
+      continue;
+    double x = base->placed_x[base_idx];
+    double y = base->placed_y[base_idx];
+    auto   mask = getRasterMask(m_num_fixed_contours + idx, angles[idx]);
+    sheet.stamp(
+      mask->grid,
+      static_cast<int>(std::lround((x + mask->origin_x - m_min_extents.x) /
+                                   cell)),
+      static_cast<int>(std::lround((y + mask->origin_y - m_min_extents.y) /
+                                   cell)));
+    sol.placed_x[idx] = x;
+    sol.placed_y[idx] = y;
+    sol.placed_ok[idx] = true;
+    sol.parts_placed++;
+  }
+  if (start > 0) {
+    sol.bounding_width = start == order.size() ? base->bounding_width
+                                               : base->step_width[start];
+  }
+  m_counters->blf_calls++;
+  m_counters->placements_reused += start;
+  m_counters->placements_computed += order.size() - start;
+
+  // Widest free run of every sheet row. A row can only take the mask if each
+  // row it covers is at least as free as the mask row over it is wide, which
+  // rules most full rows out without testing a single column.
+  std::vector<int> gaps(sheet.rows());
+  for (int row = 0; row < sheet.rows(); row++)
+    gaps[row] = sheet.widestGap(row);
+
+  for (size_t k = start; k < order.size(); k++) {
+    size_t idx = order[k];
+    sol.step_width[k] = sol.bounding_width;
+
+    double         angle = angles[idx];
+    size_t         contour_idx = m_num_fixed_contours + idx;
+    auto           mask = getRasterMask(contour_idx, angle);
+    const BitGrid& grid = mask->grid;
+
+    // Lowest row first, then leftmost column, as the exact BLF; a collision
+    // skips every column that would still hit the same cell. As the exact
+    // BLF prefers holes, a spot within the width already used is taken
+    // before one that grows it.
+    int  hint = 0;
+    auto search = [&](int max_col, int& col, int& row) {
+      int max_row = sheet.rows() - grid.rows();
+      for (row = 0; row <= max_row; row++) {
+        int r = 0;
+        while (r < grid.rows() && gaps[row + r] >= mask->widest_run[r])
+          r++;
+        if (r < grid.rows())
+          continue;
+        col = 0;
+        while (col <= max_col) {
+          int next = sheet.collide(grid, col, row, hint);
+          if (next < 0)
+            return true;
+          col = next;
+        }
+      }
+      return false;
+    };
+    int  used_cols = static_cast<int>(sol.bounding_width / cell);
+    int  col = 0, row = 0;
+    bool found = search(used_cols - grid.cols(), col, row) ||
+                 search(sheet.cols() - grid.cols(), col, row);
+    if (!found)
+      continue;
+    sheet.stamp(grid, col, row);
+    for (int r = row; r < row + grid.rows(); r++)
+      gaps[r] = sheet.widestGap(r);
+
+    double x = m_min_extents.x + col * cell - mask->origin_x;
+    double y = m_min_extents.y + row * cell - mask->origin_y;
+    sol.placed_x[idx] = x;
+    sol.placed_y[idx] = y;
+    sol.placed_ok[idx] = true;
+    sol.parts_placed++;
+    for (const auto& pt : rotatePolygon(m_base_contours[contour_idx], angle)) {
+      sol.bounding_width =
+        std::max(sol.bounding_width, pt.X + x - m_min_extents.x);
+    }
+  }
+  return sol;
+}
+
+// ---------- Compaction ----------
+
+bool PolyNest::PolyNest::slidePart(const ClipperLib::Paths&        ifp,
+                                   size_t                          contour_idx,
+                                   double                          angle,
+                                   const std::vector<PlacedEntry>& obstacles,
+                                   bool                            horizontal,
+                                   ClipperLib::FPoint&             pos)
+{
+  // The feasible region within a lane two grid steps wide around the line
+  // from `pos` toward the origin corner. The part can slide as far as the
+  // lane's piece that holds `pos` reaches.
+  const double eps = 2.0 / kSnapGrid;
+  Bounds       ifp_box;
+  for (const auto& path : ifp)
+    ifp_box.extend(path);
+  Bounds lane;
+  lane.min_x = horizontal ? ifp_box.min_x - 1.0 : pos.X - eps;
+  lane.min_y = horizontal ? pos.Y - eps : ifp_box.min_y - 1.0;
+  lane.max_x = pos.X + eps;
+  lane.max_y = pos.Y + eps;
+  ClipperLib::Path lane_rect = {
+    ClipperLib::FPoint(snapToGrid(lane.min_x), snapToGrid(lane.min_y)),
+    ClipperLib::FPoint(snapToGrid(lane.max_x), snapToGrid(lane.min_y)),
+    ClipperLib::FPoint(snapToGrid(lane.max_x), snapToGrid(lane.max_y)),
+    ClipperLib::FPoint(snapToGrid(lane.min_x), snapToGrid(lane.max_y))
+  };
+
+  ClipperLib::Paths in_lane;
+  {
+    ClipperLib::Clipper c;
+    c.AddPaths(ifp, ClipperLib::ptSubject, true);
+    c.AddPath(lane_rect, ClipperLib::ptClip, true);
+    c.Execute(ClipperLib::ctIntersection,
+              in_lane,
+              ClipperLib::pftNonZero,
+              ClipperLib::pftNonZero);
+  }
+  if (in_lane.empty())
+    return false;
+
+  Bounds part_box;
+  part_box.extend(rotatePolygon(m_base_contours[contour_idx], angle));
+  ClipperLib::Clipper c;
+  c.AddPaths(in_lane, ClipperLib::ptSubject, true);
+  for (const auto& pe : obstacles) {
+    if (!nfpBounds(pe.bounds, part_box).overlaps(lane))
+      continue;
+    NfpCache::Entry nfp =
+      getNfpCached(pe.contour_idx, pe.angle, contour_idx, angle);
+    c.AddPaths(translatePaths(*nfp, pe.x, pe.y), ClipperLib::ptClip, true);
+  }
+  ClipperLib::Paths feasible;
+  c.Execute(ClipperLib::ctDifference,
+            feasible,
+            ClipperLib::pftNonZero,
+            ClipperLib::pftNonZero);
+
+  // `pos` usually lies on the boundary of its piece, so pieces are matched
+  // by their bounds; should several match, the shortest slide is taken
+  bool   found = false;
+  double reach = horizontal ? pos.X : pos.Y;
+  for (const auto& path : feasible) {
+    Bounds box;
+    box.extend(path);
+    if (box.min_x > pos.X + eps || box.max_x < pos.X - eps ||
+        box.min_y > pos.Y + eps || box.max_y < pos.Y - eps)
+      continue;
+    double piece_reach = horizontal ? box.min_x : box.min_y;
+    reach = found ? std::max(reach, piece_reach) : piece_reach;
+    found = true;
+  }
+  if (!found)
+    return false;
+  if (horizontal)
+    pos.X = std::min(pos.X, reach);
+  else
+    pos.Y = std::min(pos.Y, reach);
+  return true;
+}
+
+bool PolyNest::PolyNest::compactPart(
+  size_t                          contour_idx,
+  double                          angle,
+  const std::vector<PlacedEntry>& obstacles,
+  ClipperLib::FPoint&             pos)
+{
+  ClipperLib::Paths ifp = computeIfp(
+    rotatePolygon(m_base_contours[contour_idx], angle), contour_idx, angle);
+  if (ifp.empty())
+    return false;
+
+  // Alternate left and down until neither gets anywhere
+  for (int i = 0; i < 8; i++) {
+    ClipperLib::FPoint start = pos;
+    if (!slidePart(ifp, contour_idx, angle, obstacles, true, pos)) {
+      if (i == 0)
+        return false;
+      break;
+    }
+    slidePart(ifp, contour_idx, angle, obstacles, false, pos);
+    if (start.X - pos.X < kCompactionTolerance &&
+        start.Y - pos.Y < kCompactionTolerance) {
+      pos = start;
+      break;
+    }
+  }
+  return true;
+}
+
+int PolyNest::PolyNest::compactSolution(NestingSolution& sol)
+{
+  const size_t n = m_unplaced_parts.size();
+
+  // Every placed part in world coordinates, fixed parts first; `part` maps
+  // an entry back to its unplaced index (n for fixed parts)
+  std::vector<PlacedEntry>      placed;
+  std::vector<size_t>           part;
+  std::vector<ClipperLib::Path> outlines;
+  auto add = [&](size_t contour_idx, double angle, double x, double y,
+                 size_t idx) {
+    ClipperLib::Path outline = translatePaths(
+      { rotatePolygon(m_base_contours[contour_idx], angle) }, x, y)[0];
+    Bounds b;
+    b.extend(outline);
+    placed.push_back({ contour_idx, angle, x, y, b });
+    part.push_back(idx);
+    outlines.push_back(std::move(outline));
+  };
+  for (const auto& fp : m_fixed_placed)
+    add(fp.part_idx, fp.angle, fp.x, fp.y, n);
+  for (size_t i = 0; i < n; i++) {
+    if (sol.placed_ok[i]) {
+      add(m_num_fixed_contours + i,
+          sol.part_angles[i],
+          sol.placed_x[i],
+          sol.placed_y[i],
+          i);
+    }
+  }
+
+  // A part sitting in a hole of another moves along with the outermost part
+  // holding it and is never compacted itself
+  const size_t        none = placed.size();
+  std::vector<size_t> host(placed.size(), none);
+  for (size_t i = 0; i < placed.size(); i++) {
+    for (size_t j = 0; j < placed.size(); j++) {
+      const Bounds& inner = placed[i].bounds;
+      const Bounds& outer = placed[j].bounds;
+      if (j == i || inner.min_x < outer.min_x || inner.max_x > outer.max_x ||
+          inner.min_y < outer.min_y || inner.max_y > outer.max_y ||
+          !pointInPath(outlines[i].front(), outlines[j]))
+        continue;
+      if (host[i] == none ||
+          std::fabs(ClipperLib::Area(outlines[j])) >
+            std::fabs(ClipperLib::Area(outlines[host[i]])))
+        host[i] = j;
+    }
+  }
+
+  auto move = [&](size_t k, double angle, const ClipperLib::FPoint& pos) {
+    double dx = pos.X - placed[k].x;
+    double dy = pos.Y - placed[k].y;
+    for (size_t m = 0; m < placed.size(); m++) {
+      if (m != k && host[m] != k)
+        continue;
+      PlacedEntry& pe = placed[m];
+      if (m == k)
+        pe.angle = angle;
+      pe.x += dx;
+      pe.y += dy;
+      pe.bounds = Bounds();
+      pe.bounds.extend(
+        rotatePolygon(m_base_contours[pe.contour_idx], pe.angle));
+      pe.bounds.min_x += pe.x;
+      pe.bounds.max_x += pe.x;
+      pe.bounds.min_y += pe.y;
+      pe.bounds.max_y += pe.y;
+    }
+  };
+
+  int moves = 0;
+  int passes = 0;
+  while (passes < kCompactionPasses) {
+    passes++;
+    // Leftmost first, so the room each part frees is there for the next
+    std::vector<size_t> queue;
+    for (size_t k = 0; k < placed.size(); k++) {
+      if (part[k] < n && host[k] == none)
+        queue.push_back(k);
+    }
+    std::sort(queue.begin(), queue.end(), [&](size_t a, size_t b) {
+      return placed[a].bounds.min_x < placed[b].bounds.min_x;
+    });
+
+    int pass_moves = 0;
+    for (size_t k : queue) {
+      std::vector<PlacedEntry> obstacles;
+      bool                     hosting = false;
+      for (size_t m = 0; m < placed.size(); m++) {
+        if (m != k && host[m] != k)
+          obstacles.push_back(placed[m]);
+        hosting = hosting || host[m] == k;
+      }
+
+      const PlacedEntry  entry = placed[k];
+      ClipperLib::FPoint pos(entry.x, entry.y);
+      if (compactPart(entry.contour_idx, entry.angle, obstacles, pos) &&
+          (pos.X != entry.x || pos.Y != entry.y)) {
+        move(k, entry.angle, pos);
+        pass_moves++;
+      }
+
+      // Jiggle: the neighbouring allowed rotations, centred where the part
+      // is, take its place if they end further left. Parts holding others
+      // keep their rotation.
+      if (hosting || m_allowed_rotations.size() < 2 ||
+          m_unplaced_parts[part[k]].m_rotation != RotationMode::Free)
+        continue;
+      size_t slot = std::find(m_allowed_rotations.begin(),
+                              m_allowed_rotations.end(),
+                              placed[k].angle) -
+                    m_allowed_rotations.begin();
+      if (slot == m_allowed_rotations.size())
+        continue;
+      const size_t count = m_allowed_rotations.size();
+      for (size_t other : { (slot + 1) % count, (slot + count - 1) % count }) {
+        double angle = m_allowed_rotations[other];
+        Bounds current = placed[k].bounds;
+        Bounds turned;
+        turned.extend(
+          rotatePolygon(m_base_contours[entry.contour_idx], angle));
+        ClipperLib::FPoint at(
+          snapToGrid((current.min_x + current.max_x - turned.min_x -
+                      turned.max_x) / 2),
+          snapToGrid((current.min_y + current.max_y - turned.min_y -
+                      turned.max_y) / 2));
+        if (!compactPart(entry.contour_idx, angle, obstacles, at) ||
+            at.X + turned.max_x > current.max_x - kCompactionTolerance)
+          continue;
+        move(k, angle, at);
+        pass_moves++;
+        break;
+      }
+    }
+    moves += pass_moves;
+    if (pass_moves == 0)
+      break;
+  }
+
+  if (moves == 0)
+    return 0;
+  double width = 0;
+  for (size_t k = 0; k < placed.size(); k++) {
+    if (part[k] == n)
+      continue;
+    sol.placed_x[part[k]] = placed[k].x;
+    sol.placed_y[part[k]] = placed[k].y;
+    sol.part_angles[part[k]] = placed[k].angle;
+    width = std::max(width, placed[k].bounds.max_x - m_min_extents.x);
+  }
+  LOG_F(INFO,
+        "Compaction: %d moves in %d passes, width %.1f -> %.1f",
+        moves,
+        passes,
+        sol.bounding_width,
+        width);
+  sol.bounding_width = width;
+  return moves;
+}
+
 // ---------- Simulated Annealing ----------
 
+std::vector<double> PolyNest::PolyNest::rotationCandidates(size_t part_idx,
+                                                           int    level,
+                                                           double around) const
+{
+  switch (m_unplaced_parts[part_idx].m_rotation) {
+    case RotationMode::Fixed:
+      return { 0.0 };
+    case RotationMode::Flip:
+      return { 0.0, 180.0 };
+    case RotationMode::Free:
+      break;
+  }
+
+  // Snapped to the fine steps, so every candidate is an allowed rotation
+  // and shares its cached NFPs
+  std::vector<double> angles;
+  const double        step = m_rotation_step;
+  auto                add = [&](double angle) {
+    angle = std::fmod(std::round(angle / step) * step + 360.0, 360.0);
+    if (std::find(angles.begin(), angles.end(), angle) == angles.end())
+      angles.push_back(angle);
+  };
+  if (level < kRotationLevels - 1) {
+    const double spacing = level == 0 ? 90.0 : 15.0;
+    for (double angle = 0; angle < 360.0; angle += spacing)
+      add(angle);
+  }
+  else {
+    int reach = std::max(1, static_cast<int>(7.5 / step));
+    for (int k = -reach; k <= reach; k++)
+      add(around + k * step);
+  }
+  return angles;
+}
+
 double PolyNest::PolyNest::evaluateFitness(const NestingSolution& sol)
 {
   double material_width = m_max_extents.x - m_min_extents.x;
   double utilization =
     (material_width > 0) ? (1.0 - sol.bounding_width / material_width) : 0.0;
+  if (m_fill_by_area) {
+    // Placed area dominates; once every part fits it's constant and the
+    // used length decides, as for a single sheet
+    double material_area =
+      material_width * (m_max_extents.y - m_min_extents.y);
+    double placed_area = 0;
+    for (size_t i = 0; i < sol.placed_ok.size(); i++) {
+      if (sol.placed_ok[i])
+        placed_area += m_part_areas[i];
+    }
+    return (material_area > 0 ? placed_area / material_area : 0.0) * 1e5 +
+           utilization * 100.0;
+  }
   return sol.parts_placed * 1000.0 + utilization * 100.0;
 }
 
@@ -650,29 +2373,114 @@ NestingSolution
 PolyNest::PolyNest::runSimulatedAnnealing(std::atomic<float>* progress)
 {
   const size_t n = m_unplaced_parts.size();
-  std::mt19937 rng(42);
 
   // Initial solution: sorted by area descending, all at 0 degrees
   std::vector<size_t> initial_order(n);
   std::iota(initial_order.begin(), initial_order.end(), 0);
   std::vector<double> initial_angles(n, 0.0);
 
-  NestingSolution current = runBLF(initial_order, initial_angles);
-  NestingSolution best = current;
-  double          current_fitness = evaluateFitness(current);
-  double          best_fitness = current_fitness;
+  AnnealingShared shared;
+  shared.best = placeParts(initial_order, initial_angles);
+  shared.best_fitness = evaluateFitness(shared.best);
+  publishBest(shared.best, shared.best_fitness);
+
+  // Each chain gets an equal share of the iteration budget and cools faster so
+  // it still sweeps the full temperature range. With one chain this is exactly
+  // the serial annealer.
+  const unsigned chains = m_thread_count;
+  const int      chain_iterations =
+    (m_sa_max_iterations + static_cast<int>(chains) - 1) /
+    static_cast<int>(chains);
+  const double chain_cooling = std::pow(m_sa_cooling_rate, chains);
+
+  if (chains == 1) {
+    runAnnealingChain(
+      m_seed, chain_iterations, chain_cooling, false, shared, progress);
+  }
+  else {
+    std::vector<std::thread> workers;
+    workers.reserve(chains);
+    for (unsigned i = 0; i < chains; i++) {
+      workers.emplace_back([&, i] {
+        runAnnealingChain(
+          m_seed + i, chain_iterations, chain_cooling, true, shared, progress);
+      });
+    }
+    for (auto& worker : workers)
+      worker.join();
+  }
+
+  LOG_F(INFO,
+        "SA complete (%u chains): placed %d/%zu parts, bounding width: %.1f",
+        chains,
+        shared.best.parts_placed,
+        n,
+        shared.best.bounding_width);
+  size_t reused = m_counters->placements_reused;
+  size_t computed = m_counters->placements_computed;
+  LOG_F(INFO,
+        "BLF placements: %zu reused, %zu recomputed (%.0f%% reused), %zu "
+        "no-op moves skipped",
+        reused,
+        computed,
+        reused + computed > 0 ? 100.0 * reused / (reused + computed) : 0.0,
+        static_cast<size_t>(m_counters->moves_skipped));
+  return std::move(shared.best);
+}
+
+void PolyNest::PolyNest::runAnnealingChain(unsigned            seed,
+                                           int                 iterations,
+                                           double              cooling_rate,
+                                           bool                exchange,
+                                           AnnealingShared&    shared,
+                                           std::atomic<float>* progress)
+{
+  const size_t n = m_unplaced_parts.size();
+  std::mt19937 rng(seed);
+
+  NestingSolution current;
+  double          current_fitness;
+  {
+    std::lock_guard lock(shared.mutex);
+    current = shared.best;
+    current_fitness = shared.best_fitness;
+  }
 
   double    temp = m_sa_initial_temp;
-  int       no_improve_count = 0;
   const int early_stop_threshold = 2000;
+  // Chains adopt the global best this often so no chain wastes its budget in
+  // a poor basin
+  const int exchange_interval = 250;
 
   std::uniform_real_distribution<double> accept_dist(0.0, 1.0);
   std::uniform_int_distribution<size_t>  part_dist(0, n - 1);
   std::uniform_int_distribution<int>     move_dist(0, 2);
-  std::uniform_int_distribution<size_t>  rot_dist(
-    0, m_allowed_rotations.size() - 1);
 
-  for (int iter = 0; iter < m_sa_max_iterations; iter++) {
+  // Rotation moves start at right angles and get finer as the chain works
+  // through its budget, or sooner once a level stops paying off. Most parts
+  // settle at a few angles, so the NFPs of the others are never built.
+  int level = 0;
+  int stalled = 0;
+
+  for (int iter = 0; iter < iterations && !shared.stop && !stopRequested();
+       iter++) {
+    if (exchange && iter > 0 && iter % exchange_interval == 0) {
+      std::lock_guard lock(shared.mutex);
+      if (shared.best_fitness > current_fitness) {
+        current = shared.best;
+        current_fitness = shared.best_fitness;
+      }
+    }
+
+    int scheduled = std::min(kRotationLevels - 1,
+                             static_cast<int>(static_cast<int64_t>(iter) *
+                                              kRotationLevels / iterations));
+    if (level < scheduled ||
+        (level < kRotationLevels - 1 && stalled >= early_stop_threshold / 2)) {
+      level++;
+      stalled = 0;
+    }
+
     // Generate neighbor
     std::vector<size_t> new_order = current.part_order;
     std::vector<double> new_angles = current.part_angles;
@@ -699,63 +2507,378 @@ PolyNest::PolyNest::runSimulatedAnnealing(std::atomic<float>* progress)
     }
     else {
       // Change one part's rotation
-      size_t i = part_dist(rng);
-      new_angles[new_order[i]] = m_allowed_rotations[rot_dist(rng)];
+      size_t              idx = new_order[part_dist(rng)];
+      std::vector<double> angles =
+        rotationCandidates(idx, level, new_angles[idx]);
+      new_angles[idx] = angles[std::uniform_int_distribution<size_t>(
+        0, angles.size() - 1)(rng)];
     }
 
-    NestingSolution neighbor = runBLF(new_order, new_angles);
-    double          neighbor_fitness = evaluateFitness(neighbor);
-
-    // Accept or reject
-    double delta = neighbor_fitness - current_fitness;
-    if (delta > 0 || accept_dist(rng) < std::exp(delta / temp)) {
-      current = std::move(neighbor);
-      current_fitness = neighbor_fitness;
+    // A move that only exchanges identical shapes at equal angles (common
+    // with duplicated parts) yields the same layout; don't evaluate it
+    bool no_op = true;
+    for (size_t k = 0; k < n && no_op; k++) {
+      no_op = samePlacementInput(new_order[k],
+                                 new_angles[new_order[k]],
+                                 current.part_order[k],
+                                 current.part_angles[current.part_order[k]]);
+    }
 
-      if (current_fitness > best_fitness) {
-        best = current;
-        best_fitness = current_fitness;
-        no_improve_count = 0;
-      }
-      else {
-        no_improve_count++;
+    bool improved = false;
+    if (no_op) {
+      m_counters->moves_skipped++;
+    }
+    else {
+      NestingSolution neighbor = placeParts(new_order, new_angles, &current);
+      double          neighbor_fitness = evaluateFitness(neighbor);
+
+      // Accept or reject
+      double delta = neighbor_fitness - current_fitness;
+      if (delta > 0 || accept_dist(rng) < std::exp(delta / temp)) {
+        current = std::move(neighbor);
+        current_fitness = neighbor_fitness;
+
+        std::lock_guard lock(shared.mutex);
+        if (current_fitness > shared.best_fitness) {
+          shared.best = current;
+          shared.best_fitness = current_fitness;
+          improved = true;
+        }
       }
+      if (improved)
+        publishBest(current, current_fitness);
+    }
+    if (improved) {
+      shared.no_improve = 0;
+      stalled = 0;
     }
     else {
-      no_improve_count++;
+      shared.no_improve++;
+      stalled++;
     }
 
-    temp *= m_sa_cooling_rate;
+    temp *= cooling_rate;
 
-    bool all_parts_placed = best.parts_placed == static_cast<int>(n);
+    int  done = ++shared.iterations_done;
+    int  no_improve_count = shared.no_improve;
+    bool all_parts_placed;
+    {
+      std::lock_guard lock(shared.mutex);
+      all_parts_placed = shared.best.parts_placed == static_cast<int>(n);
+    }
     if (progress) {
-      // Contribution from iterations
-      float p1 = 0.1f + 0.9f * static_cast<float>(iter) /
+      // Contribution from iterations (summed over all chains)
+      float p1 = 0.1f + 0.9f * static_cast<float>(done) /
                           static_cast<float>(m_sa_max_iterations);
       // Push convergence to 100% when we're exiting early
       float p2 = (1.f - p1) * static_cast<float>(no_improve_count) /
                  static_cast<float>(early_stop_threshold);
-      progress->store(all_parts_placed ? p1 + p2 : p1);
+      reportProgress(progress, all_parts_placed ? p1 + p2 : p1);
     }
 
-    // Early termination if all parts placed and no improvement
-    if (all_parts_placed && no_improve_count >= early_stop_threshold) {
-      LOG_F(
-        INFO, "SA early termination at iteration %d (no improvement)", iter);
+    // Early termination if all parts placed and no chain has improved lately,
+    // once this chain has reached the finest rotations
+    if (all_parts_placed && level == kRotationLevels - 1 &&
+        no_improve_count >= early_stop_threshold) {
+      if (!shared.stop.exchange(true))
+        LOG_F(INFO,
+              "SA early termination after %d iterations (no improvement)",
+              done);
+      break;
+    }
+  }
+}
+
+// ---------- Genetic Algorithm ----------
+
+NestingSolution
+PolyNest::PolyNest::runGeneticAlgorithm(std::atomic<float>* progress)
+{
+  const size_t n = m_unplaced_parts.size();
+  std::mt19937 rng(m_seed);
+
+  struct Individual {
+    NestingSolution sol;
+    double          fitness = 0;
+  };
+  // Big enough to keep a few distinct orders around, small enough that the
+  // evaluation budget still buys a useful number of generations
+  const size_t population = std::clamp<size_t>(2 * n, 12, 40);
+  const size_t elites = 2;
+  const int    generations =
+    std::max(1, m_sa_max_iterations / static_cast<int>(population));
+  // Generations without a better best before giving up, as the annealer's
+  // 2000 iterations
+  const int early_stop_generations =
+    std::max(1, 2000 / static_cast<int>(population));
+
+  // Fitness of individuals [from, end) of `pop`, spread over the worker
+  // threads. Each one is placed against `bases[i - from]`, the parent whose
+  // order it starts with, so BLF reuses their common prefix.
+  auto evaluate = [&](std::vector<Individual>&                    pop,
+                      size_t                                      from,
+                      const std::vector<const NestingSolution*>& bases) {
+    std::atomic<size_t> next{ from };
+    auto                work = [&] {
+      for (size_t i = next++; i < pop.size(); i = next++) {
+        NestingSolution& sol = pop[i].sol;
+        sol = placeParts(sol.part_order, sol.part_angles, bases[i - from]);
+        pop[i].fitness = evaluateFitness(sol);
+      }
+    };
+    unsigned threads = std::min<unsigned>(
+      m_thread_count, static_cast<unsigned>(pop.size() - from));
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++)
+      workers.emplace_back(work);
+    work();
+    for (auto& worker : workers)
+      worker.join();
+  };
+  auto by_fitness = [](const Individual& a, const Individual& b) {
+    return a.fitness > b.fitness;
+  };
+
+  // Seeded with the annealer's initial layout (largest first, unrotated) and
+  // shuffles of it at right angles
+  std::uniform_int_distribution<size_t> part_dist(0, n - 1);
+  std::vector<Individual>               pop(population);
+  for (size_t i = 0; i < population; i++) {
+    NestingSolution& sol = pop[i].sol;
+    sol.part_order.resize(n);
+    std::iota(sol.part_order.begin(), sol.part_order.end(), 0);
+    sol.part_angles.assign(n, 0.0);
+    if (i == 0)
+      continue;
+    for (size_t k = 0; k < n / 2 + 1; k++)
+      std::swap(sol.part_order[part_dist(rng)],
+                sol.part_order[part_dist(rng)]);
+    for (size_t idx = 0; idx < n; idx++) {
+      std::vector<double> angles = rotationCandidates(idx, 0, 0.0);
+      sol.part_angles[idx] = angles[std::uniform_int_distribution<size_t>(
+        0, angles.size() - 1)(rng)];
+    }
+  }
+  evaluate(pop, 0, std::vector<const NestingSolution*>(population, nullptr));
+  std::sort(pop.begin(), pop.end(), by_fitness);
+  publishBest(pop.front().sol, pop.front().fitness);
+
+  std::uniform_real_distribution<double> chance(0.0, 1.0);
+  std::uniform_int_distribution<size_t>  pick(0, population - 1);
+  // Fittest of three picked at random; `pop` is sorted, so lower is fitter
+  auto tournament = [&]() -> const Individual& {
+    size_t best = pick(rng);
+    for (int k = 0; k < 2; k++)
+      best = std::min(best, pick(rng));
+    return pop[best];
+  };
+
+  // Rotations get finer over the generations, as in the annealer
+  int level = 0;
+  int stalled = 0;
+  int generation = 0;
+  for (; generation < generations && !stopRequested(); generation++) {
+    int scheduled = std::min(kRotationLevels - 1,
+                             generation * kRotationLevels / generations);
+    if (level < scheduled || (level < kRotationLevels - 1 &&
+                              stalled >= early_stop_generations / 2)) {
+      level++;
+      stalled = 0;
+    }
+
+    std::vector<Individual> next(pop.begin(), pop.begin() + elites);
+    std::vector<const NestingSolution*> bases;
+    while (next.size() < population) {
+      const Individual& a = tournament();
+      const Individual& b = tournament();
+
+      // Order crossover: a slice of `a` stays where it is, the remaining
+      // parts fill the other positions in the order they have in `b`
+      size_t lo = part_dist(rng);
+      size_t hi = part_dist(rng);
+      if (lo > hi)
+        std::swap(lo, hi);
+      NestingSolution child;
+      child.part_order.assign(n, 0);
+      std::vector<bool> taken(n, false);
+      for (size_t k = lo; k <= hi; k++) {
+        child.part_order[k] = a.sol.part_order[k];
+        taken[a.sol.part_order[k]] = true;
+      }
+      size_t pos = 0;
+      for (size_t idx : b.sol.part_order) {
+        if (taken[idx])
+          continue;
+        if (pos == lo)
+          pos = hi + 1;
+        child.part_order[pos++] = idx;
+      }
+      // Each part keeps the rotation of either parent
+      child.part_angles.resize(n);
+      for (size_t idx = 0; idx < n; idx++) {
+        child.part_angles[idx] =
+          chance(rng) < 0.5 ? a.sol.part_angles[idx] : b.sol.part_angles[idx];
+      }
+
+      // Mutation: swap two positions, turn one part
+      if (n >= 2 && chance(rng) < 0.3)
+        std::swap(child.part_order[part_dist(rng)],
+                  child.part_order[part_dist(rng)]);
+      if (chance(rng) < 0.3) {
+        size_t              idx = part_dist(rng);
+        std::vector<double> angles =
+          rotationCandidates(idx, level, child.part_angles[idx]);
+        child.part_angles[idx] = angles[std::uniform_int_distribution<size_t>(
+          0, angles.size() - 1)(rng)];
+      }
+
+      bases.push_back(lo == 0 ? &a.sol : &b.sol);
+      next.push_back({ std::move(child), 0 });
+    }
+    evaluate(next, elites, bases);
+    std::sort(next.begin(), next.end(), by_fitness);
+
+    if (next.front().fitness > pop.front().fitness) {
+      publishBest(next.front().sol, next.front().fitness);
+      stalled = 0;
+    }
+    else {
+      stalled++;
+    }
+    pop = std::move(next);
+
+    float done = static_cast<float>((generation + 1) * population) /
+                 static_cast<float>(m_sa_max_iterations);
+    reportProgress(progress, 0.1f + 0.9f * std::min(done, 1.0f));
+    if (pop.front().sol.parts_placed == static_cast<int>(n) &&
+        level == kRotationLevels - 1 && stalled >= early_stop_generations) {
+      LOG_F(INFO,
+            "GA early termination after %d generations (no improvement)",
+            generation + 1);
+      generation++;
       break;
     }
   }
 
   LOG_F(INFO,
-        "SA complete: placed %d/%zu parts, bounding width: %.1f",
-        best.parts_placed,
+        "GA complete (%zu individuals, %d generations): placed %d/%zu parts, "
+        "bounding width: %.1f",
+        population,
+        generation,
+        pop.front().sol.parts_placed,
         n,
-        best.bounding_width);
-  return best;
+        pop.front().sol.bounding_width);
+  return std::move(pop.front().sol);
 }
 
 // ---------- Main entry point ----------
 
+bool PolyNest::PolyNest::stopRequested() const
+{
+  if (m_control->stop)
+    return true;
+  if (std::chrono::steady_clock::now() < m_control->deadline)
+    return false;
+  if (!m_control->stop.exchange(true))
+    LOG_F(INFO, "Nesting time budget of %.1f s used up", m_time_budget);
+  return true;
+}
+
+void PolyNest::PolyNest::publishBest(const NestingSolution& sol,
+                                     double                 fitness)
+{
+  std::vector<NestControl::Placement> layout;
+  layout.reserve(sol.parts_placed);
+  for (size_t i = 0; i < m_unplaced_parts.size(); i++) {
+    if (!sol.placed_ok[i])
+      continue;
+    const PolyPart& part = m_unplaced_parts[i];
+    layout.push_back({ part.m_offset_x,
+                       part.m_offset_y,
+                       part.m_angle,
+                       part.m_visible,
+                       sol.placed_x[i],
+                       sol.placed_y[i],
+                       sol.part_angles[i] });
+  }
+
+  // Chains may publish out of order; only a better layout replaces the
+  // current one
+  std::lock_guard lock(m_control->mutex);
+  if (!m_control->best.empty() && fitness <= m_control->best_fitness)
+    return;
+  m_control->best.swap(layout);
+  m_control->best_fitness = fitness;
+  m_control->version++;
+}
+
+bool PolyNest::PolyNest::applyBestLayout(uint64_t& version)
+{
+  auto apply = [](const NestControl::Placement& p) {
+    *p.offset_x = p.x;
+    *p.offset_y = p.y;
+    *p.angle = p.a;
+    *p.visible = p.shown;
+  };
+  std::lock_guard lock(m_control->mutex);
+  if (m_control->version == version)
+    return false;
+  // Finished sheets first; the preview is of a later one
+  for (const auto& p : m_control->finished)
+    apply(p);
+  m_control->finished.clear();
+  for (const auto& p : m_control->best)
+    apply(p);
+  version = m_control->version;
+  return true;
+}
+
+void PolyNest::PolyNest::reportProgress(std::atomic<float>* progress,
+                                        float               fraction) const
+{
+  if (progress) {
+    progress->store(m_progress_base +
+                    m_progress_span * std::clamp(fraction, 0.0f, 1.0f));
+  }
+}
+
+NestingSolution PolyNest::PolyNest::nestSheet(std::atomic<float>* progress)
+{
+  NestingSolution best;
+  double          best_fitness = -1;
+  if (m_unplaced_parts.size() > 1) {
+    // Multiple parts: search orders and rotations
+    best = m_optimizer == NestOptimizer::Genetic
+             ? runGeneticAlgorithm(progress)
+             : runSimulatedAnnealing(progress);
+  }
+  else {
+    // Single part: BLF at each rotation, coarse to fine around the best
+    reportProgress(progress, 0.1f);
+    double best_angle = 0;
+    for (int level = 0; level < kRotationLevels; level++) {
+      for (double angle : rotationCandidates(0, level, best_angle)) {
+        std::vector<size_t> order = { 0 };
+        std::vector<double> angles = { angle };
+        NestingSolution     candidate = placeParts(order, angles);
+        double              fitness = evaluateFitness(candidate);
+        if (fitness > best_fitness) {
+          best_fitness = fitness;
+          best = candidate;
+          best_angle = angle;
+        }
+      }
+    }
+  }
+
+  // Compaction slides parts against exact NFPs, which also closes up the
+  // extra spacing the raster leaves. Re-placing a raster layout with exact
+  // BLF instead loses its within-the-used-width search and never wins.
+  if (m_compaction && best.parts_placed > 0)
+    m_stats.compaction_moves += compactSolution(best);
+  return best;
+}
+
 int PolyNest::PolyNest::placeAllUnplacedParts(std::atomic<float>* progress)
 {
   if (m_unplaced_parts.empty()) {
@@ -764,52 +2887,136 @@ int PolyNest::PolyNest::placeAllUnplacedParts(std::atomic<float>* progress)
     return 0;
   }
 
-  const size_t    n = m_unplaced_parts.size();
-  NestingSolution sol;
-
-  if (n == 1) {
-    // Single part: try each rotation with BLF, pick best
-    if (progress)
-      progress->store(0.1f);
-
-    NestingSolution best_single;
-    double          best_fitness = -1;
+  // Sheets are filled one after another; the parts a sheet can't take are
+  // nested again on the next one. Progress is split by the number of sheets
+  // the part area needs at least.
+  const PolyPoint sheet_min = m_min_extents;
+  const PolyPoint sheet_max = m_max_extents;
+  const double    sheet_width = sheet_max.x - sheet_min.x;
+  const double    sheet_area = sheet_width * (sheet_max.y - sheet_min.y);
+  const double    total_area =
+    std::accumulate(m_part_areas.begin(), m_part_areas.end(), 0.0);
+  const int estimated_sheets =
+    sheet_area > 0
+      ? std::clamp(static_cast<int>(std::ceil(total_area / sheet_area)),
+                   1,
+                   m_max_sheets)
+      : 1;
+  m_control->deadline =
+    m_time_budget > 0
+      ? std::chrono::steady_clock::now() +
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(m_time_budget))
+      : std::chrono::steady_clock::time_point::max();
 
-    for (double angle : m_allowed_rotations) {
-      std::vector<size_t> order = { 0 };
-      std::vector<double> angles = { angle };
-      NestingSolution     candidate = runBLF(order, angles);
-      double              fitness = evaluateFitness(candidate);
-      if (fitness > best_fitness) {
-        best_fitness = fitness;
-        best_single = candidate;
+  NestingSolution sol;
+  for (int sheet = 0; sheet < m_max_sheets; sheet++) {
+    if (sheet > 0) {
+      double shift = sheet * (sheet_width + m_sheet_spacing);
+      m_min_extents = PolyPoint(sheet_min.x + shift, sheet_min.y);
+      m_max_extents = PolyPoint(sheet_max.x + shift, sheet_max.y);
+      prepareBaseContours();
+    }
+    m_fill_by_area = sheet + 1 < m_max_sheets;
+    m_progress_span = 1.0f / static_cast<float>(estimated_sheets);
+    m_progress_base =
+      std::min(sheet, estimated_sheets - 1) * m_progress_span;
+
+    sol = nestSheet(progress);
+    if (sol.parts_placed > 0)
+      m_stats.sheets_used = sheet + 1;
+
+    // Publish the placements for applyBestLayout() and keep the rest for
+    // the next sheet. The sheet is final from here on, so its layout stops
+    // being previewed.
+    std::vector<PolyPart>               overflow;
+    std::vector<NestControl::Placement> placements;
+    for (size_t i = 0; i < m_unplaced_parts.size(); i++) {
+      const PolyPart& part = m_unplaced_parts[i];
+      if (sol.placed_ok[i]) {
+        placements.push_back({ part.m_offset_x,
+                               part.m_offset_y,
+                               part.m_angle,
+                               part.m_visible,
+                               sol.placed_x[i],
+                               sol.placed_y[i],
+                               sol.part_angles[i] });
+      }
+      else {
+        // May still show a preview position
+        placements.push_back({ part.m_offset_x,
+                               part.m_offset_y,
+                               part.m_angle,
+                               part.m_visible,
+                               part.m_start_x,
+                               part.m_start_y,
+                               part.m_start_angle,
+                               false });
+        overflow.push_back(part);
       }
     }
-    sol = best_single;
-  }
-  else {
-    // Multiple parts: run simulated annealing
-    sol = runSimulatedAnnealing(progress);
+    {
+      std::lock_guard lock(m_control->mutex);
+      m_control->finished.insert(
+        m_control->finished.end(), placements.begin(), placements.end());
+      m_control->best.clear();
+      m_control->version++;
+    }
+    m_stats.parts_placed += sol.parts_placed;
+    m_stats.bounding_width = sol.bounding_width;
+    m_unplaced_parts = std::move(overflow);
+    if (m_unplaced_parts.empty())
+      break;
+    // An empty extra sheet that takes nothing means the rest can't fit at all
+    if (sheet > 0 && sol.parts_placed == 0)
+      break;
+    if (sheet + 1 < m_max_sheets)
+      LOG_F(INFO,
+            "Sheet %d full, %zu parts overflow to sheet %d",
+            sheet + 1,
+            m_unplaced_parts.size(),
+            sheet + 2);
   }
+  m_min_extents = sheet_min;
+  m_max_extents = sheet_max;
 
-  // Apply results back to parts through their pointers
+  m_stats.nfp_computed = m_nfp_cache->computedCount();
+  m_stats.nfp_time_ms = m_nfp_cache->computeTimeMs();
+  m_stats.nfp_cache_hits = m_nfp_cache->hits();
+  m_stats.nfp_cache_misses = m_nfp_cache->misses();
+  LOG_F(INFO,
+        "NFP cache: %zu hits, %zu misses, %zu NFPs computed in %.0f ms",
+        m_stats.nfp_cache_hits,
+        m_stats.nfp_cache_misses,
+        m_stats.nfp_computed,
+        m_stats.nfp_time_ms);
+  m_stats.blf_calls = m_counters->blf_calls;
+  m_stats.placements_reused = m_counters->placements_reused;
+  m_stats.placements_computed = m_counters->placements_computed;
+  m_stats.moves_skipped = m_counters->moves_skipped;
+  if (m_max_sheets > 1)
+    LOG_F(INFO, "Nested onto %d sheet(s)", m_stats.sheets_used);
+
+  // Whatever is left doesn't fit on any sheet. It goes back to where it was
+  // before nesting, not to where a preview last put it.
   int failed_count = 0;
-  for (size_t i = 0; i < n; i++) {
-    auto& part = m_unplaced_parts[i];
-    *part.m_offset_x = sol.placed_x[i];
-    *part.m_offset_y = sol.placed_y[i];
-    *part.m_angle = sol.part_angles[i];
-    *part.m_visible = true;
-    if (sol.placed_ok[i]) {
-      part.build();
-    }
-    else {
+  {
+    std::lock_guard lock(m_control->mutex);
+    for (const auto& part : m_unplaced_parts) {
+      m_control->finished.push_back({ part.m_offset_x,
+                                   part.m_offset_y,
+                                   part.m_angle,
+                                   part.m_visible,
+                                   part.m_start_x,
+                                   part.m_start_y,
+                                   part.m_start_angle });
       failed_count++;
       LOG_F(WARNING,
-            "Could not place part %zu ('%s') — not enough material",
-            i,
+            "Could not place part '%s' — not enough material",
             part.m_part_name.c_str());
     }
+    if (failed_count > 0)
+      m_control->version++;
   }
 
   if (progress)
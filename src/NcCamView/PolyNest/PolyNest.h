@@ -1,15 +1,23 @@
 #ifndef POLY_NEST_
 #define POLY_NEST_
 
-#include <NanoCut.h>
+#include "RasterGrid.h"
 #include <NcRender/geometry/clipper.h>
 #include <loguru.hpp>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <random>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -35,6 +43,11 @@ public:
   bool             m_is_inside;
 };
 
+// Rotations a part may take when nested. Flip allows 0 and 180 degrees only
+// (e.g. to keep the grain or a brushed finish running one way), Fixed keeps
+// it at 0.
+enum class RotationMode : uint8_t { Free, Flip, Fixed };
+
 class PolyPart {
 public:
   std::vector<PolyGon> m_polygons;
@@ -45,7 +58,13 @@ public:
   double*              m_offset_y;
   double*              m_angle;
   bool*                m_visible;
+  // Pose when pushed. The values behind the pointers belong to the UI
+  // thread, so a running nest reads these instead.
+  double               m_start_x = 0;
+  double               m_start_y = 0;
+  double               m_start_angle = 0;
   std::string          m_part_name;
+  RotationMode         m_rotation = RotationMode::Free;
   PolyPart()
   {
     m_bbox_min.x = 0;
@@ -60,30 +79,109 @@ public:
   void      build();
 };
 
-// NFP cache key: identifies the NFP between two contours at specific angles
+// How no-fit polygons are built. Hull uses the convex hull of both contours,
+// which is fast but never lets concave parts interlock. Exact decomposes both
+// contours into convex pieces and unions the pairwise Minkowski sums, giving
+// the true (possibly holed) NFP.
+enum class NfpMode : uint8_t { Hull, Exact };
+
+// How candidate layouts are placed while annealing. Exact runs the NFP
+// bottom-left fill throughout. Raster places parts on a packed occupancy grid
+// of the material, which is far cheaper per layout. Parts are rasterized
+// conservatively, so raster layouts never overlap but may keep up to a cell
+// of extra spacing, which compaction against exact NFPs closes up again.
+enum class NestEvaluator : uint8_t { Exact, Raster };
+
+// How part orders and rotations are searched; either places candidates with
+// the selected NestEvaluator. Annealing walks one layout at a time per chain
+// and suits jobs of a few, mostly large parts. Genetic evolves a population
+// with order crossover and rotation mutation, evaluating each generation in
+// parallel, which tends to do better with many small parts.
+enum class NestOptimizer : uint8_t { Annealing, Genetic };
+
+// NFP cache key: identifies the NFP between two contours at specific angles.
+// Contours are identified by a hash of their quantized geometry rather than
+// their index in a run, so entries stay valid across runs and sessions.
 struct NfpKey {
-  size_t stat_idx;
-  size_t orb_idx;
-  double stat_angle;
-  double orb_angle;
-  bool   operator==(const NfpKey& other) const
+  uint64_t stat_hash;
+  uint64_t orb_hash;
+  double   stat_angle;
+  double   orb_angle;
+  NfpMode  mode;
+  bool     operator==(const NfpKey& other) const
   {
-    return stat_idx == other.stat_idx && orb_idx == other.orb_idx &&
-           stat_angle == other.stat_angle && orb_angle == other.orb_angle;
+    return stat_hash == other.stat_hash && orb_hash == other.orb_hash &&
+           stat_angle == other.stat_angle && orb_angle == other.orb_angle &&
+           mode == other.mode;
   }
 };
 
 struct NfpKeyHash {
   size_t operator()(const NfpKey& k) const
   {
-    size_t h = std::hash<size_t>{}(k.stat_idx);
-    h ^= std::hash<size_t>{}(k.orb_idx) << 1;
-    h ^= std::hash<double>{}(k.stat_angle) << 2;
-    h ^= std::hash<double>{}(k.orb_angle) << 3;
-    return h;
+    uint64_t h = k.stat_hash * 0x9E3779B97F4A7C15ull;
+    h ^= k.orb_hash + 0x7F4A7C159E3779B9ull + (h << 6) + (h >> 2);
+    h ^= std::hash<double>{}(k.stat_angle) + (h << 6) + (h >> 2);
+    h ^= std::hash<double>{}(k.orb_angle) + (h << 6) + (h >> 2);
+    h ^= static_cast<uint64_t>(k.mode);
+    return static_cast<size_t>(h);
   }
 };
 
+// LRU cache of NFPs shared by the annealing workers and kept across nesting
+// runs. Each shard has its own lock and LRU list; entries are handed out as
+// shared pointers so an eviction never invalidates an NFP still in use. The
+// cache can be persisted to a binary file so a part library nests near
+// instantly across sessions.
+class NfpCache {
+public:
+  using Entry = std::shared_ptr<const ClipperLib::Paths>;
+
+  static constexpr size_t kDefaultMaxBytes = 64 * 1024 * 1024;
+  explicit NfpCache(size_t max_bytes = kDefaultMaxBytes);
+
+  Entry find(const NfpKey& key); // Counts a hit or a miss
+  // Stores `nfp` unless another worker got there first; returns the entry
+  Entry insert(const NfpKey& key, ClipperLib::Paths nfp);
+  void  clear();
+
+  bool load(const std::string& filename);
+  bool save(const std::string& filename);
+
+  // Instrumentation for NestStats (reset by resetCounters())
+  void   resetCounters();
+  void   recordCompute(double ms);
+  size_t hits() const { return m_hits; }
+  size_t misses() const { return m_misses; }
+  size_t computedCount() const { return m_computed; }
+  double computeTimeMs() const { return m_compute_us / 1000.0; }
+  size_t sizeBytes();
+  size_t entryCount();
+
+private:
+  static constexpr size_t kShards = 16;
+  struct Node {
+    NfpKey key;
+    Entry  nfp;
+    size_t bytes;
+  };
+  using LruList = std::list<Node>; // Most recently used first
+  struct Shard {
+    std::mutex                                                mutex;
+    LruList                                                   lru;
+    std::unordered_map<NfpKey, LruList::iterator, NfpKeyHash> map;
+    size_t                                                    bytes = 0;
+  };
+  std::array<Shard, kShards> m_shards;
+  size_t                     m_max_bytes;
+  std::atomic<size_t>        m_hits{ 0 };
+  std::atomic<size_t>        m_misses{ 0 };
+  std::atomic<size_t>        m_computed{ 0 };
+  std::atomic<int64_t>       m_compute_us{ 0 };
+
+  Shard& shardFor(const NfpKey& key);
+};
+
 // Result of a complete nesting attempt
 struct NestingSolution {
   std::vector<size_t> part_order;
@@ -93,6 +191,78 @@ struct NestingSolution {
   std::vector<bool>   placed_ok;
   int                 parts_placed = 0;
   double              bounding_width = 0;
+  // Bounding width before placing order position k; lets runBLF resume a
+  // neighbour from the first position where it differs from this solution
+  std::vector<double> step_width;
+};
+
+// Counters from the most recent nesting run
+struct NestStats {
+  size_t nfp_computed = 0;        // NFPs computed
+  double nfp_time_ms = 0;         // Time spent computing NFPs
+  size_t nfp_cache_hits = 0;      // NFP lookups served from the cache
+  size_t nfp_cache_misses = 0;    // NFP lookups that had to compute
+  int    parts_placed = 0;        // Parts placed by the final solution
+  double bounding_width = 0;      // Used sheet length of the final solution
+  size_t blf_calls = 0;           // runBLF evaluations
+  size_t placements_reused = 0;   // Placements copied from a prefix
+  size_t placements_computed = 0; // Placements computed with NFPs
+  size_t distinct_shapes = 0;     // Distinct contours after deduplication
+  size_t moves_skipped = 0;       // SA moves that only swapped equal shapes
+  size_t compaction_moves = 0;    // Parts moved by the compaction pass
+  int    sheets_used = 0;         // Sheets holding at least one new part
+};
+
+// Live counters updated concurrently by the annealing chains; copied into
+// NestStats when a run finishes
+struct NestCounters {
+  std::atomic<size_t> blf_calls{ 0 };
+  std::atomic<size_t> placements_reused{ 0 };
+  std::atomic<size_t> placements_computed{ 0 };
+  std::atomic<size_t> moves_skipped{ 0 };
+};
+
+// Shared between a running nest and the thread that started it: stop
+// requests (the user accepting the current layout, or the time budget), the
+// best layout found so far and the layouts of finished sheets. The annealer
+// fills a fresh buffer on every improvement and swaps it in under the lock,
+// so a reader never sees a half-written layout. Only the reader writes to
+// the parts, see PolyNest::applyBestLayout().
+struct NestControl {
+  struct Placement {
+    double* offset_x;
+    double* offset_y;
+    double* angle;
+    bool*   visible;
+    double  x;
+    double  y;
+    double  a;
+    bool    shown = true;
+  };
+  std::atomic<bool>                     stop{ false };
+  std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::time_point::max();
+  std::mutex             mutex; // Guards the layouts
+  std::vector<Placement> best;
+  double                 best_fitness = 0;
+  // Placements of finished sheets, and of parts going back to where they
+  // were because they fit no sheet, not applied yet
+  std::vector<Placement> finished;
+  uint64_t               version = 0;
+};
+
+// Axis-aligned bounds of a contour or NFP
+struct Bounds {
+  double min_x = std::numeric_limits<double>::infinity();
+  double min_y = std::numeric_limits<double>::infinity();
+  double max_x = -std::numeric_limits<double>::infinity();
+  double max_y = -std::numeric_limits<double>::infinity();
+  void   extend(const ClipperLib::Path& path);
+  bool   overlaps(const Bounds& other) const
+  {
+    return min_x <= other.max_x && other.min_x <= max_x &&
+           min_y <= other.max_y && other.min_y <= max_y;
+  }
 };
 
 // Record of an already-placed part (fixed during nesting)
@@ -113,15 +283,69 @@ private:
   std::vector<PolyPart> m_placed_parts;
 
   // NFP algorithm state
-  std::unordered_map<NfpKey, ClipperLib::Paths, NfpKeyHash> m_nfp_cache;
-  ClipperLib::Path                                          m_material_rect;
-  std::vector<FixedPart>                                    m_fixed_placed;
-  std::vector<double>                                       m_allowed_rotations;
+  std::shared_ptr<NfpCache> m_nfp_cache = std::make_shared<NfpCache>();
+  std::vector<FixedPart>    m_fixed_placed;
+  // Every angle a part can take, at m_rotation_step increments. Annealing
+  // only reaches the fine ones in its last stage, see rotationCandidates().
+  std::vector<double>       m_allowed_rotations;
+  double                    m_rotation_step = 5.0;
+
+  // Irregular material (a remnant): outline plus holes such as defects or
+  // earlier cuts, all CCW in sheet 0 coordinates. An empty outline means the
+  // plain extents rectangle.
+  ClipperLib::Path  m_material_outline;
+  ClipperLib::Paths m_material_holes;
+  PolyPoint         m_material_min;      // Outline bounds, sheet 0
+  uint64_t          m_material_hash = 0; // Inner-fit cache key
+
+  // NFP construction mode and run instrumentation
+  NfpMode                       m_nfp_mode = NfpMode::Exact;
+  NestStats                     m_stats;
+  std::unique_ptr<NestCounters> m_counters = std::make_unique<NestCounters>();
+
+  // Multi-sheet layout: sheet k is the material extents shifted right by k
+  // sheet widths plus spacings. Parts overflow to the next sheet when the
+  // current one is full, up to m_max_sheets.
+  int    m_max_sheets = 1;
+  double m_sheet_spacing = 0;
+  // Intermediate sheets are filled by placed area rather than part count, so
+  // large parts aren't left over to open extra sheets
+  bool                m_fill_by_area = false;
+  std::vector<double> m_part_areas; // Outline area per unplaced part
 
-  // SA parameters
+  // Stop requests and the live best layout; behind a pointer so the nest
+  // stays movable
+  std::unique_ptr<NestControl> m_control = std::make_unique<NestControl>();
+  double                       m_time_budget = 0; // Seconds, 0 = unlimited
+  bool                         stopRequested() const;
+  void publishBest(const NestingSolution& sol, double fitness);
+
+  // Progress of the current sheet maps into [base, base + span] of the run
+  float m_progress_base = 0.0f;
+  float m_progress_span = 1.0f;
+  void  reportProgress(std::atomic<float>* progress, float fraction) const;
+
+  NestOptimizer m_optimizer = NestOptimizer::Annealing;
+
+  // SA parameters; the iteration count is the GA's evaluation budget too
   double m_sa_initial_temp = 1000.0;
   double m_sa_cooling_rate = 0.9995;
   int    m_sa_max_iterations = 20000;
+  // Seeds the optimizer's random moves; chain i of the annealer uses seed + i
+  unsigned m_seed = 42;
+  // Number of annealing chains run in parallel (1 = the serial annealer)
+  unsigned m_thread_count = 1;
+
+  // State shared by the parallel annealing chains. The global best is
+  // guarded by `mutex`; the counters drive progress and early termination.
+  struct AnnealingShared {
+    std::mutex        mutex;
+    NestingSolution   best;
+    double            best_fitness = 0;
+    std::atomic<int>  iterations_done{ 0 };
+    std::atomic<int>  no_improve{ 0 };
+    std::atomic<bool> stop{ false };
+  };
 
   // Part building helpers (kept from original)
   bool   checkIfPointIsInsidePath(std::vector<PolyPoint> path, PolyPoint point);
@@ -137,43 +361,265 @@ private:
   // Base contour storage: [0..F-1] = fixed parts, [F..F+N-1] = unplaced parts
   std::vector<ClipperLib::Path> m_base_contours;
   size_t                        m_num_fixed_contours = 0;
+  // Convex pieces of each base contour (a single hull in NfpMode::Hull).
+  // Rotation preserves convexity, so pieces are decomposed once per run.
+  std::vector<ClipperLib::Paths> m_base_pieces;
+  // Geometry hash of each base contour (the NFP cache key)
+  std::vector<uint64_t> m_base_hashes;
+  // Canonical id per base contour: identical contours (hash match confirmed
+  // by a tolerance compare) share the id of the first one, and with it the
+  // convex pieces and every NFP
+  std::vector<size_t> m_canonical_ids;
+
+  // Part-in-part: closed holes of a base contour that are large enough to
+  // take the smallest unplaced part, in the contour's local frame. Placed
+  // parts expose them as extra inner-fit regions.
+  struct HoleRegion {
+    ClipperLib::Path contour; // CCW
+    uint64_t         hash;    // Inner-fit cache key (seeded apart from NFPs)
+    double           area;
+  };
+  std::vector<std::vector<HoleRegion>> m_base_holes;
+  bool                                 m_part_in_part = true;
+  bool                                 m_compaction = true;
+
+  // Raster evaluation: occupancy of the current sheet before any unplaced
+  // part goes in (material outside, fixed parts) and part masks per
+  // canonical contour and allowed rotation, built on first use. The cache
+  // sits behind a pointer so the nest stays movable.
+  NestEvaluator m_evaluator = NestEvaluator::Exact;
+  double        m_raster_cell = 2.0; // mm
+  BitGrid       m_raster_sheet;
+  struct RasterCache {
+    std::shared_mutex                                           mutex;
+    std::vector<std::vector<std::shared_ptr<const RasterMask>>> masks;
+  };
+  std::unique_ptr<RasterCache> m_raster_cache =
+    std::make_unique<RasterCache>();
+
+  // True if unplaced parts `a` and `b` are the same shape at the same angle,
+  // i.e. BLF places them identically
+  bool samePlacementInput(size_t a, double a_angle, size_t b, double b_angle)
+    const
+  {
+    return a_angle == b_angle &&
+           m_canonical_ids[m_num_fixed_contours + a] ==
+             m_canonical_ids[m_num_fixed_contours + b];
+  }
 
   // NFP utilities
   static ClipperLib::Path  reflectPolygon(const ClipperLib::Path& poly);
   static ClipperLib::Path  rotatePolygon(const ClipperLib::Path& poly,
                                          double                  angle);
   ClipperLib::Path         getBaseContour(const PolyPart& part) const;
-  ClipperLib::Paths        computeNfp(const ClipperLib::Path& stationary,
-                                      const ClipperLib::Path& orbiting);
-  ClipperLib::Paths        computeIfp(const ClipperLib::Path& part_contour);
-  const ClipperLib::Paths& getNfpCached(size_t stat_idx,
+  std::vector<HoleRegion>  getBaseHoles(const PolyPart& part,
+                                        double          min_area) const;
+  ClipperLib::Paths        decomposeContour(const ClipperLib::Path& contour);
+  ClipperLib::Paths        computeNfp(const ClipperLib::Paths& stationary,
+                                      const ClipperLib::Paths& orbiting);
+  ClipperLib::Paths        computeIfp(const ClipperLib::Path& part_contour,
+                                      size_t                  contour_idx,
+                                      double                  angle);
+  NfpCache::Entry          getNfpCached(size_t stat_idx,
                                         double stat_angle,
                                         size_t orb_idx,
                                         double orb_angle);
+  // Inner-fit region of hole `hole` of base contour `owner_idx`, cached in
+  // the NFP cache under the hole's hash
+  NfpCache::Entry          getHoleIfpCached(size_t owner_idx,
+                                            size_t hole,
+                                            double owner_angle,
+                                            size_t orb_idx,
+                                            double orb_angle);
+  // Inner-fit region of base contour `orb_idx` in the irregular material,
+  // cached per rotation under the material hash
+  NfpCache::Entry          getMaterialIfpCached(size_t orb_idx,
+                                                double orb_angle);
+
+  // A part placed during a BLF run. The world-space bounds let the feasible
+  // region search skip obstacles whose NFP can't reach the query area.
+  struct PlacedEntry {
+    size_t contour_idx; // index into m_base_contours
+    double angle;
+    double x, y;
+    Bounds bounds;
+  };
+  // The parts placed so far in a BLF run, bucketed by the rows of the sheet
+  // their bounds span. Kept for the whole run, so finding the obstacles near
+  // an area visits only the rows it covers instead of every placed part.
+  class PlacedIndex {
+  public:
+    PlacedIndex(double min_y, double max_y);
+    void add(const PlacedEntry& entry);
+    const std::vector<PlacedEntry>& entries() const { return m_entries; }
+    // Indices of the entries whose bounds overlap `box`, ascending
+    void query(const Bounds& box, std::vector<size_t>& out);
+
+  private:
+    size_t row(double y) const;
+
+    static constexpr size_t          kRows = 64;
+    double                           m_min_y;
+    double                           m_row_height;
+    std::vector<PlacedEntry>         m_entries;
+    std::vector<std::vector<size_t>> m_rows;
+    std::vector<uint64_t>            m_seen; // Last query to return an entry
+    uint64_t                         m_query = 0;
+  };
 
   // BLF placement
+  bool findBottomLeftPlacement(const ClipperLib::Paths& ifp,
+                               const ClipperLib::Path&  rotated,
+                               size_t                   contour_idx,
+                               double                   angle,
+                               PlacedIndex&             placed,
+                               ClipperLib::FPoint&      bl);
+  bool findHolePlacement(const ClipperLib::Path& rotated,
+                         size_t                  contour_idx,
+                         double                  angle,
+                         PlacedIndex&            placed,
+                         ClipperLib::FPoint&     bl);
   NestingSolution    runBLF(const std::vector<size_t>& order,
-                            const std::vector<double>& angles);
+                            const std::vector<double>& angles,
+                            const NestingSolution*     base = nullptr);
+  NestingSolution    emptySolution(const std::vector<size_t>& order,
+                                   const std::vector<double>& angles) const;
+  // Leading positions of `order` that place exactly as they did in `base`
+  size_t             reusablePrefix(const std::vector<size_t>& order,
+                                    const std::vector<double>& angles,
+                                    const NestingSolution*     base) const;
+  // Places a candidate layout with the selected evaluator
+  NestingSolution    placeParts(const std::vector<size_t>& order,
+                                const std::vector<double>& angles,
+                                const NestingSolution*     base = nullptr);
+
+  // Raster evaluation
+  // Outline CCW plus usable holes CW of a base contour at `angle`
+  ClipperLib::Paths                 partRegion(size_t contour_idx,
+                                               double angle) const;
+  std::shared_ptr<const RasterMask> getRasterMask(size_t contour_idx,
+                                                  double angle);
+  void                              prepareRasterSheet();
+  NestingSolution runRasterBLF(const std::vector<size_t>& order,
+                               const std::vector<double>& angles,
+                               const NestingSolution*     base = nullptr);
   ClipperLib::FPoint findBottomLeftPoint(const ClipperLib::Paths& feasible);
 
+  // Compaction
+  // Moves `pos` as far toward the origin corner along one axis as the
+  // obstacles let the part go; false if `pos` isn't feasible for it
+  bool slidePart(const ClipperLib::Paths&        ifp,
+                 size_t                          contour_idx,
+                 double                          angle,
+                 const std::vector<PlacedEntry>& obstacles,
+                 bool                            horizontal,
+                 ClipperLib::FPoint&             pos);
+  // Slides left and down in turn until the part stops
+  bool compactPart(size_t                          contour_idx,
+                   double                          angle,
+                   const std::vector<PlacedEntry>& obstacles,
+                   ClipperLib::FPoint&             pos);
+  // Slides every part of `sol` left and down against the others, trying the
+  // neighbouring rotations as well, until none moves. Returns the number of
+  // moves made.
+  int  compactSolution(NestingSolution& sol);
+
+  // Rotation search, coarse to fine: level 0 are right angles, level 1 steps
+  // of 15 degrees, level 2 the fine steps within 7.5 degrees of `around`.
+  // All are restricted by the part's rotation mode.
+  std::vector<double> rotationCandidates(size_t part_idx,
+                                         int    level,
+                                         double around) const;
+
   // Simulated annealing
   NestingSolution runSimulatedAnnealing(std::atomic<float>* progress);
+  void            runAnnealingChain(unsigned            seed,
+                                    int                 iterations,
+                                    double              cooling_rate,
+                                    bool                exchange,
+                                    AnnealingShared&    shared,
+                                    std::atomic<float>* progress);
   double          evaluateFitness(const NestingSolution& sol);
 
+  // Genetic algorithm
+  NestingSolution runGeneticAlgorithm(std::atomic<float>* progress);
+
+  // Builds the base contour, piece, hash and hole tables for the current
+  // fixed and unplaced parts
+  void            prepareBaseContours();
+  // Nests the unplaced parts into the current extents
+  NestingSolution nestSheet(std::atomic<float>* progress);
+
 public:
   PolyNest();
+  // Rectangular material; replaces any outline set by setMaterial()
   void setExtents(PolyPoint min, PolyPoint max);
+  // Irregular material: the first contour is the outline, the rest are holes
+  // (defects, earlier cuts). The extents become the outline bounds.
+  void setMaterial(const std::vector<std::vector<PolyPoint>>& contours);
+  // Uncut remainder of the material around the placed parts, opened by
+  // `min_width` so slivers between parts are dropped. Returns the largest
+  // region as outline followed by holes, or nothing if no region is left.
+  std::vector<std::vector<PolyPoint>> computeRemnant(double min_width) const;
   void pushUnplacedPolyPart(std::vector<std::vector<PolyPoint>> p,
                             double*                             offset_x,
                             double*                             offset_y,
                             double*                             angle,
-                            bool*                               visible);
+                            bool*                               visible,
+                            RotationMode rotation = RotationMode::Free);
   void pushPlacedPolyPart(std::vector<std::vector<PolyPoint>> p,
                           double*                             offset_x,
                           double*                             offset_y,
                           double*                             angle,
                           bool*                               visible);
-  void beginPlaceUnplacedPolyParts();
+  void setNfpMode(NfpMode mode) { m_nfp_mode = mode; }
+  void setEvaluator(NestEvaluator evaluator) { m_evaluator = evaluator; }
+  void setOptimizer(NestOptimizer optimizer) { m_optimizer = optimizer; }
+  // Cell size of the raster evaluator in mm, e.g. the kerf width
+  void setRasterCellSize(double cell_size)
+  {
+    m_raster_cell = std::max(cell_size, 0.1);
+  }
+  // Share an NFP cache that outlives this nest (e.g. owned by the view and
+  // persisted to disk)
+  void setNfpCache(std::shared_ptr<NfpCache> cache)
+  {
+    m_nfp_cache = std::move(cache);
+  }
+  // Allow up to `max_sheets` sheets of the set extents, laid out left to
+  // right `spacing` apart; parts that don't fit overflow to the next sheet
+  void setSheets(int max_sheets, double spacing)
+  {
+    m_max_sheets = std::max(1, max_sheets);
+    m_sheet_spacing = spacing;
+  }
+  // Let parts nest inside the holes of larger placed parts
+  void setPartInPart(bool enabled) { m_part_in_part = enabled; }
+  // Finest rotation increment in degrees (default 5); rounded so it divides
+  // 90 evenly
+  void setRotationStep(double degrees);
+  // Slide parts together after annealing (on by default)
+  void setCompaction(bool enabled) { m_compaction = enabled; }
+  void setAnnealingIterations(int iterations)
+  {
+    m_sa_max_iterations = iterations;
+  }
+  // Equal seeds repeat a single-threaded run exactly
+  void setSeed(unsigned seed) { m_seed = seed; }
+  // Wall-clock budget of one placeAllUnplacedParts() run; 0 = unlimited
+  void setTimeBudget(double seconds) { m_time_budget = seconds; }
+  // Ends annealing early and keeps the best layout found so far; sheets not
+  // reached yet get a single greedy pass. Safe to call from any thread.
+  void requestStop() { m_control->stop = true; }
+  // Writes the layouts published after `version` to the parts and advances
+  // `version`; false if there is nothing new. The only writer of the parts
+  // while a nest runs, so call it from the thread that owns them, also once
+  // the nest has returned to pick up its last sheet.
+  bool applyBestLayout(uint64_t& version);
+  // Number of annealing chains to run in parallel; 0 picks the core count
+  void             setThreadCount(unsigned threads);
+  const NestStats& getStats() const { return m_stats; }
+  void             beginPlaceUnplacedPolyParts();
   int  placeAllUnplacedParts(std::atomic<float>* progress); // Returns number of
                                                             // parts that failed
                                                             // to place
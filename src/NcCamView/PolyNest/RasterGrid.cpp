@@ -0,0 +1,239 @@
+#include "RasterGrid.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace PolyNest {
+
+BitGrid::BitGrid(int cols, int rows)
+  : m_cols(std::max(cols, 0)), m_rows(std::max(rows, 0)),
+    m_words((m_cols + 63) / 64 + 1),
+    m_bits(static_cast<size_t>(m_words) * m_rows, 0)
+{
+}
+
+void BitGrid::set(int col, int row)
+{
+  m_bits[row * m_words + (col >> 6)] |= uint64_t(1) << (col & 63);
+}
+
+void BitGrid::invert()
+{
+  for (int r = 0; r < m_rows; r++) {
+    uint64_t* row = &m_bits[r * m_words];
+    for (int w = 0; w < m_words - 1; w++)
+      row[w] = ~row[w];
+    // Keep the cells past the last column and the spare word clear
+    if (m_cols & 63)
+      row[m_words - 2] &= (uint64_t(1) << (m_cols & 63)) - 1;
+  }
+}
+
+size_t BitGrid::count() const
+{
+  size_t n = 0;
+  for (uint64_t word : m_bits)
+    n += std::popcount(word);
+  return n;
+}
+
+int BitGrid::widestRun(int row) const
+{
+  int widest = 0;
+  for (int col = nextSet(row, 0); col < m_cols;) {
+    int end = nextClear(row, col);
+    widest = std::max(widest, end - col);
+    col = nextSet(row, end);
+  }
+  return widest;
+}
+
+int BitGrid::widestGap(int row) const
+{
+  int widest = 0;
+  for (int col = nextClear(row, 0); col < m_cols;) {
+    int end = nextSet(row, col);
+    widest = std::max(widest, end - col);
+    col = nextClear(row, end);
+  }
+  return widest;
+}
+
+void BitGrid::fillCentres(const ClipperLib::Paths& region,
+                          double                   origin_x,
+                          double                   origin_y,
+                          double                   cell)
+{
+  std::vector<double> crossings;
+  for (int r = 0; r < m_rows; r++) {
+    double y = origin_y + (r + 0.5) * cell;
+    crossings.clear();
+    for (const auto& path : region) {
+      for (size_t i = 0, j = path.size() - 1; i < path.size(); j = i++) {
+        const ClipperLib::FPoint& a = path[j];
+        const ClipperLib::FPoint& b = path[i];
+        if ((a.Y <= y) != (b.Y <= y))
+          crossings.push_back(a.X + (y - a.Y) / (b.Y - a.Y) * (b.X - a.X));
+      }
+    }
+    std::sort(crossings.begin(), crossings.end());
+
+    uint64_t* row = &m_bits[r * m_words];
+    for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+      int first = static_cast<int>(
+        std::ceil((crossings[k] - origin_x) / cell - 0.5));
+      int last = static_cast<int>(
+        std::floor((crossings[k + 1] - origin_x) / cell - 0.5));
+      first = std::max(first, 0);
+      last = std::min(last, m_cols - 1);
+      // Whole words at a time
+      while (first <= last) {
+        int      word = first >> 6;
+        int      lo = first & 63;
+        int      hi = std::min(last - (word << 6), 63);
+        uint64_t bits = hi == 63 ? ~uint64_t(0) : (uint64_t(1) << (hi + 1)) - 1;
+        row[word] |= bits & ~((uint64_t(1) << lo) - 1);
+        first = (word + 1) << 6;
+      }
+    }
+  }
+}
+
+// A cell touches the region iff its centre lies within half a cell diagonal
+// of it. The square joins of the offset circumscribe the round ones, so the
+// offset region contains the exact one.
+void BitGrid::fillTouched(const ClipperLib::Paths& region,
+                          double                   origin_x,
+                          double                   origin_y,
+                          double                   cell)
+{
+  ClipperLib::ClipperOffset offset;
+  ClipperLib::Paths         grown;
+  offset.AddPaths(region, ClipperLib::jtSquare, ClipperLib::etClosedPolygon);
+  offset.Execute(grown, cell * M_SQRT1_2);
+  fillCentres(grown, origin_x, origin_y, cell);
+}
+
+void BitGrid::fillInterior(const ClipperLib::Paths& region,
+                           double                   origin_x,
+                           double                   origin_y,
+                           double                   cell)
+{
+  ClipperLib::ClipperOffset offset;
+  ClipperLib::Paths         shrunk;
+  offset.AddPaths(region, ClipperLib::jtSquare, ClipperLib::etClosedPolygon);
+  offset.Execute(shrunk, -cell * M_SQRT1_2);
+  fillCentres(shrunk, origin_x, origin_y, cell);
+}
+
+int BitGrid::nextSet(int row, int col) const
+{
+  if (col >= m_cols)
+    return m_cols;
+  const uint64_t* bits = &m_bits[row * m_words];
+  int             word = col >> 6;
+  uint64_t        w = bits[word] & (~uint64_t(0) << (col & 63));
+  while (!w) {
+    if (++word >= m_words - 1)
+      return m_cols;
+    w = bits[word];
+  }
+  return std::min((word << 6) + std::countr_zero(w), m_cols);
+}
+
+int BitGrid::nextClear(int row, int col) const
+{
+  if (col >= m_cols)
+    return m_cols;
+  const uint64_t* bits = &m_bits[row * m_words];
+  int             word = col >> 6;
+  uint64_t        w = ~bits[word] & (~uint64_t(0) << (col & 63));
+  while (!w) {
+    if (++word >= m_words - 1)
+      return m_cols;
+    w = ~bits[word];
+  }
+  return std::min((word << 6) + std::countr_zero(w), m_cols);
+}
+
+int BitGrid::nextGap(int row, int col, int length) const
+{
+  while (col + length <= m_cols) {
+    int start = nextClear(row, col);
+    int end = nextSet(row, start);
+    if (end - start >= length)
+      return start;
+    col = end;
+  }
+  return m_cols;
+}
+
+int BitGrid::collideRow(const BitGrid& mask, int r, int col, int row) const
+{
+  const uint64_t* mask_row = &mask.m_bits[r * mask.m_words];
+  const uint64_t* grid_row = &m_bits[(row + r) * m_words];
+  for (int w = 0; w < mask.m_words - 1; w++) {
+    if (!mask_row[w])
+      continue;
+    // The 64 grid cells under this mask word
+    int      bit = col + (w << 6);
+    int      shift = bit & 63;
+    uint64_t under = grid_row[bit >> 6] >> shift;
+    if (shift)
+      under |= grid_row[(bit >> 6) + 1] << (64 - shift);
+    uint64_t hit = mask_row[w] & under;
+    if (!hit)
+      continue;
+
+    // The run of mask cells covering the hit keeps colliding in this grid
+    // row until it reaches a gap at least as wide as itself
+    int j = (w << 6) + std::countr_zero(hit);
+    int start = j;
+    while (start > 0 && mask.test(start - 1, r))
+      start--;
+    int end = mask.nextClear(r, j);
+    return nextGap(row + r, col + j + 1, end - start) - start;
+  }
+  return -1;
+}
+
+int BitGrid::collide(const BitGrid& mask, int col, int row, int& hint) const
+{
+  // Neighbouring offsets tend to be blocked by the same mask row
+  if (hint >= 0 && hint < mask.m_rows) {
+    int next = collideRow(mask, hint, col, row);
+    if (next >= 0)
+      return next;
+  }
+  for (int r = 0; r < mask.m_rows; r++) {
+    if (r == hint)
+      continue;
+    int next = collideRow(mask, r, col, row);
+    if (next >= 0) {
+      hint = r;
+      return next;
+    }
+  }
+  return -1;
+}
+
+void BitGrid::stamp(const BitGrid& mask, int col, int row)
+{
+  for (int r = 0; r < mask.m_rows; r++) {
+    const uint64_t* mask_row = &mask.m_bits[r * mask.m_words];
+    uint64_t*       grid_row = &m_bits[(row + r) * m_words];
+    for (int w = 0; w < mask.m_words - 1; w++) {
+      uint64_t bits = mask_row[w];
+      if (!bits)
+        continue;
+      int bit = col + (w << 6);
+      int shift = bit & 63;
+      grid_row[bit >> 6] |= bits << shift;
+      if (shift)
+        grid_row[(bit >> 6) + 1] |= bits >> (64 - shift);
+    }
+  }
+}
+
+} // namespace PolyNest
@@ -0,0 +1,88 @@
+#ifndef POLY_NEST_RASTER_GRID_
+#define POLY_NEST_RASTER_GRID_
+
+#include <NcRender/geometry/clipper.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PolyNest {
+
+// Occupancy bitmap over a grid of square cells, row-major with 64 cells per
+// word. Cell (0, 0) is the bottom-left one. Every row carries one spare zero
+// word so reads of a word-unaligned window never leave the row.
+class BitGrid {
+public:
+  BitGrid() = default;
+  BitGrid(int cols, int rows);
+
+  int  cols() const { return m_cols; }
+  int  rows() const { return m_rows; }
+  bool test(int col, int row) const
+  {
+    return (m_bits[row * m_words + (col >> 6)] >> (col & 63)) & 1;
+  }
+  void   set(int col, int row);
+  void   invert();
+  size_t count() const; // Set cells
+  // Longest run of set / clear cells in `row`
+  int    widestRun(int row) const;
+  int    widestGap(int row) const;
+
+  // Sets every cell that `region` (outlines CCW, holes CW) touches, with the
+  // lower-left corner of cell (0, 0) at `origin_x`, `origin_y`. Conservative:
+  // may also set cells next to the region, never misses one.
+  void fillTouched(const ClipperLib::Paths& region,
+                   double                   origin_x,
+                   double                   origin_y,
+                   double                   cell);
+  // Sets every cell lying entirely inside `region`; conservative the other
+  // way round
+  void fillInterior(const ClipperLib::Paths& region,
+                    double                   origin_x,
+                    double                   origin_y,
+                    double                   cell);
+
+  // Whether `mask` with its cell (0, 0) on (`col`, `row`) hits a set cell.
+  // Returns -1 if it doesn't, else the first column at which the mask row
+  // that collided finds a gap wide enough for the run of cells that hit,
+  // which is the next candidate worth testing on this row. `hint` is the
+  // mask row tested first and is set to the one that collided.
+  int  collide(const BitGrid& mask, int col, int row, int& hint) const;
+  // Sets the cells of `mask` with its cell (0, 0) on (`col`, `row`)
+  void stamp(const BitGrid& mask, int col, int row);
+
+private:
+  int                   m_cols = 0;
+  int                   m_rows = 0;
+  int                   m_words = 0; // Per row, including the spare word
+  std::vector<uint64_t> m_bits;
+
+  // First set / clear cell of `row` at or after `col`, or cols() if none
+  int  nextSet(int row, int col) const;
+  int  nextClear(int row, int col) const;
+  // First column at or after `col` starting `length` clear cells
+  int  nextGap(int row, int col, int length) const;
+  // collide() for mask row `r` alone
+  int  collideRow(const BitGrid& mask, int r, int col, int row) const;
+
+  // Sets the cells whose centres lie inside `region` (even-odd)
+  void fillCentres(const ClipperLib::Paths& region,
+                   double                   origin_x,
+                   double                   origin_y,
+                   double                   cell);
+};
+
+// A part rasterized at one rotation. Its cell (0, 0) has its lower-left
+// corner at (origin_x, origin_y) in the part's local frame.
+struct RasterMask {
+  BitGrid          grid;
+  double           origin_x = 0;
+  double           origin_y = 0;
+  std::vector<int> widest_run; // grid.widestRun() of every row
+};
+
+} // namespace PolyNest
+
+#endif
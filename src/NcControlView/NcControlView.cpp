@@ -274,19 +274,15 @@ void NcControlView::makeActive()
 
   // Clear color is handled by renderer initialization
 }
-void NcControlView::loadGCodeFromLines(std::vector<std::string>&& lines)
+void NcControlView::loadProgram(std::shared_ptr<const Program> program)
 {
   if (!m_app || !m_gcode)
     return;
 
-  // Switch view first so the timer and any primitives created during parsing
-  // are associated with NcControlView (timers only fire in their own view)
+  // Switch view first so the preview primitives are associated with
+  // NcControlView
   makeActive();
-
-  if (m_gcode->loadFromLines(std::move(lines))) {
-    m_app->getRenderer().pushTimer(0,
-                                   [this]() { return m_gcode->parseTimer(); });
-  }
+  m_gcode->loadProgram(std::move(program));
 }
 
 void NcControlView::close()
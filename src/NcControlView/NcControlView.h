@@ -245,7 +245,8 @@ public:
   void           tick() override;
   void           makeActive();
   void           close();
-  void           loadGCodeFromLines(std::vector<std::string>&& lines);
+  // Previews a program from the CAM view, ready to run
+  void           loadProgram(std::shared_ptr<const Program> program);
 
   void handleMouseEvent(const MouseButtonEvent& e,
                         const InputState&       input) override;
@@ -3,8 +3,10 @@
 #include "../hmi/hmi.h"
 #include <NcControlView/NcControlView.h>
 #include <NcRender/geometry/geometry.h>
+#include <cmath>
 #include <fstream>
 #include <loguru.hpp>
+#include <numbers>
 
 // Helper function for splitting strings (can remain as a free function)
 std::vector<std::string> gcode_split(std::string str, char delimiter)
@@ -36,6 +38,7 @@ void GCode::resetParseState()
   m_lines_consumed = 0;
   m_line_index = 0;
   m_last_rapid_line = 0;
+  m_position = { 0.0, 0.0 };
   m_current_path.points.clear();
   m_paths.clear();
   m_app->getDialogs().showProgressWindow(true);
@@ -53,6 +56,7 @@ bool GCode::openFile(const std::string& filepath)
     return false;
   }
 
+  m_program.reset();
   m_lines.clear();
   std::string line;
   while (std::getline(file, line)) {
@@ -67,19 +71,68 @@ bool GCode::openFile(const std::string& filepath)
   return true;
 }
 
-bool GCode::loadFromLines(std::vector<std::string>&& lines)
+bool GCode::loadProgram(std::shared_ptr<const Program> program)
 {
-  if (!m_app)
+  if (!m_app || !program)
     return false;
 
-  m_lines = lines;
+  m_program = std::move(program);
+  m_lines.clear();
   m_filename = "";
   resetParseState();
-  LOG_F(INFO, "Loaded %lu lines from memory", m_line_count);
+  // The moves are all there already; no parsing, so no need to spread the
+  // preview over frames
+  const auto& steps = m_program->steps;
+  for (size_t s = 0; s < steps.size(); s++) {
+    const Program::Step& step = steps[s];
+    switch (step.op) {
+      case Program::Op::Rapid:
+        previewRapid(step.to);
+        m_last_rapid_line = s;
+        break;
+      case Program::Op::Line:
+        m_current_path.points.push_back(step.to);
+        break;
+      case Program::Op::ArcCw:
+      case Program::Op::ArcCcw: {
+        const Point2d start = m_current_path.points.empty()
+                                ? Point2d{ 0.0, 0.0 }
+                                : m_current_path.points.back();
+        pushArcPoints(step.to,
+                      { start.x + step.center.x, start.y + step.center.y },
+                      step.op == Program::Op::ArcCcw);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  finishPreview();
+  LOG_F(INFO,
+        "Loaded a program of %lu steps, %lu cuts",
+        steps.size(),
+        m_program->cuts.size());
   return true;
 }
 
-const std::vector<std::string>& GCode::getLines() const { return m_lines; }
+bool GCode::empty() const
+{
+  return m_program ? m_program->steps.empty() : m_lines.empty();
+}
+
+std::vector<std::string> GCode::linesFrom(size_t first) const
+{
+  if (!m_program) {
+    return { m_lines.begin() + std::min(first, m_lines.size()),
+             m_lines.end() };
+  }
+  std::vector<std::string> lines;
+  GCodeWriter::LineSink    sink(lines);
+  GCodeWriter              writer(sink, m_program->decimals);
+  m_program->write(writer, first);
+  writer.flush();
+  return lines;
+}
 
 nlohmann::json GCode::parseLine(const std::string& line)
 {
@@ -90,6 +143,8 @@ nlohmann::json GCode::parseLine(const std::string& line)
   std::string active_word = "";
   std::string x_value = "";
   std::string y_value = "";
+  std::string i_value = "";
+  std::string j_value = "";
   for (int x = 0; x < line_upper.size(); x++) {
     if (line_upper[x] == 'X') {
       active_word = "X";
@@ -97,6 +152,12 @@ nlohmann::json GCode::parseLine(const std::string& line)
     else if (line_upper[x] == 'Y') {
       active_word = "Y";
     }
+    else if (line_upper[x] == 'I') {
+      active_word = "I";
+    }
+    else if (line_upper[x] == 'J') {
+      active_word = "J";
+    }
     else if (line_upper[x] == 'F') {
       active_word = "F";
     }
@@ -113,15 +174,90 @@ nlohmann::json GCode::parseLine(const std::string& line)
       if (active_word == "Y") {
         y_value += line_upper[x];
       }
+      if (active_word == "I") {
+        i_value += line_upper[x];
+      }
+      if (active_word == "J") {
+        j_value += line_upper[x];
+      }
     }
   }
   // Store gcode internally as negated values since
-  // grbl does this for machine coordinates
-  ret["x"] = -atof(x_value.c_str());
-  ret["y"] = -atof(y_value.c_str());
+  // grbl does this for machine coordinates. An axis left out of the line
+  // keeps its last value.
+  if (!x_value.empty())
+    m_position.x = -atof(x_value.c_str());
+  if (!y_value.empty())
+    m_position.y = -atof(y_value.c_str());
+  ret["x"] = m_position.x;
+  ret["y"] = m_position.y;
+  // Arc centre offsets (G2/G3), relative to the start of the arc
+  ret["i"] = -atof(i_value.c_str());
+  ret["j"] = -atof(j_value.c_str());
   return ret;
 }
 
+void GCode::pushArcPoints(Point2d end, Point2d center, bool ccw)
+{
+  if (m_current_path.points.empty()) {
+    m_current_path.points.push_back(end);
+    return;
+  }
+  // Negating both axes is a half turn, so G2 stays clockwise on screen
+  const Point2d start = m_current_path.points.back();
+  const double  radius = geo::distance(center, start);
+  const double  start_angle =
+    std::atan2(start.y - center.y, start.x - center.x);
+  double sweep = std::atan2(end.y - center.y, end.x - center.x) - start_angle;
+  if (ccw && sweep <= 0.0)
+    sweep += 2.0 * std::numbers::pi;
+  else if (!ccw && sweep >= 0.0)
+    sweep -= 2.0 * std::numbers::pi;
+  // One point every 5 degrees
+  const int steps = std::max(
+    1, static_cast<int>(std::ceil(std::fabs(sweep) / (std::numbers::pi / 36))));
+  for (int k = 1; k < steps; k++) {
+    const double angle = start_angle + sweep * k / steps;
+    m_current_path.points.push_back({ center.x + radius * std::cos(angle),
+                                      center.y + radius * std::sin(angle) });
+  }
+  m_current_path.points.push_back(end);
+}
+
+void GCode::previewRapid(Point2d to)
+{
+  if (!m_current_path.points.empty()) {
+    const Point2d from = m_current_path.points.back();
+    pushCurrentPathToViewer(m_last_rapid_line);
+    m_paths.push_back(m_current_path);
+    Line* l = m_app->getRenderer().pushPrimitive<Line>(from, to);
+    l->id = "gcode";
+    l->flags = PrimitiveFlags::GCode;
+    l->m_style = "dashed";
+    l->color = &m_app->getColor(ThemeColor::TextDisabled);
+    l->matrix_callback = m_view->getTransformCallback();
+    l->visible = false;
+  }
+  m_current_path.points.clear();
+  m_current_path.points.push_back(to);
+}
+
+void GCode::finishPreview()
+{
+  pushCurrentPathToViewer(m_last_rapid_line);
+  if (m_current_path.points.size() > 0)
+    m_paths.push_back(m_current_path);
+  m_current_path.points.clear();
+  m_app->getDialogs().setProgressValue(1.0f);
+  m_app->getDialogs().showProgressWindow(false);
+  auto& stack = m_app->getRenderer().getPrimitiveStack();
+  for (size_t x = 0; x < stack.size(); x++) {
+    if ((stack.at(x)->flags & PrimitiveFlags::GCode) != PrimitiveFlags::None) {
+      stack.at(x)->visible = true;
+    }
+  }
+}
+
 void GCode::pushCurrentPathToViewer(int rapid_line)
 {
   if (!m_app || m_current_path.points.size() == 0)
@@ -186,7 +322,6 @@ bool GCode::parseTimer()
 {
   if (!m_app)
     return false;
-  auto& renderer = m_app->getRenderer();
 
   for (int x = 0; x < 1000; x++) {
     if (m_line_index < m_lines.size()) {
@@ -195,30 +330,9 @@ bool GCode::parseTimer()
       m_app->getDialogs().setProgressValue((float) m_lines_consumed /
                                             (float) m_line_count);
       if (line.find("G0") != std::string::npos) {
-        Point2d last_path_endpoint = { std::numeric_limits<int>::min(),
-                                       std::numeric_limits<int>::min() };
-        if (m_current_path.points.size() > 0) {
-          last_path_endpoint =
-            m_current_path.points[m_current_path.points.size() - 1];
-        }
-        pushCurrentPathToViewer(m_last_rapid_line);
-        if (m_current_path.points.size() > 0)
-          m_paths.push_back(m_current_path);
-        m_current_path.points.clear();
         nlohmann::json g = parseLine(line);
         try {
-          m_current_path.points.push_back({ (double) g["x"], (double) g["y"] });
-          if (last_path_endpoint.x != std::numeric_limits<int>::min() &&
-              last_path_endpoint.y != std::numeric_limits<int>::min()) {
-            Line* l = renderer.pushPrimitive<Line>(
-              last_path_endpoint, Point2d{ (double) g["x"], (double) g["y"] });
-            l->id = "gcode";
-            l->flags = PrimitiveFlags::GCode;
-            l->m_style = "dashed";
-            l->color = &m_app->getColor(ThemeColor::TextDisabled);
-            l->matrix_callback = m_view->getTransformCallback();
-            l->visible = false;
-          }
+          previewRapid({ (double) g["x"], (double) g["y"] });
         }
         catch (...) {
           LOG_F(ERROR,
@@ -240,22 +354,29 @@ bool GCode::parseTimer()
                 m_filename.c_str());
         }
       }
+      else if (line.find("G2") != std::string::npos ||
+               line.find("G3") != std::string::npos) {
+        nlohmann::json g = parseLine(line);
+        try {
+          Point2d start = m_current_path.points.empty()
+                            ? Point2d{ 0.0, 0.0 }
+                            : m_current_path.points.back();
+          pushArcPoints({ (double) g["x"], (double) g["y"] },
+                        { start.x + (double) g["i"],
+                          start.y + (double) g["j"] },
+                        line.find("G3") != std::string::npos);
+        }
+        catch (...) {
+          LOG_F(ERROR,
+                "Gcode parsing error at line %lu in file %s",
+                m_lines_consumed,
+                m_filename.c_str());
+        }
+      }
     }
     else {
       LOG_F(INFO, "Reached end of G-code lines!");
-      pushCurrentPathToViewer(m_last_rapid_line);
-      if (m_current_path.points.size() > 0)
-        m_paths.push_back(m_current_path);
-      m_current_path.points.clear();
-      m_app->getDialogs().setProgressValue(1.0f);
-      m_app->getDialogs().showProgressWindow(false);
-      auto& stack = renderer.getPrimitiveStack();
-      for (size_t x = 0; x < stack.size(); x++) {
-        if ((stack.at(x)->flags & PrimitiveFlags::GCode) !=
-            PrimitiveFlags::None) {
-          stack.at(x)->visible = true;
-        }
-      }
+      finishPreview();
       return false;
     }
   }
@@ -2,7 +2,9 @@
 #define GCODE__
 
 #include <NanoCut.h>
+#include <NcCamView/GCodeWriter/Program.h>
 #include <nlohmann/json.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -34,18 +36,25 @@ public:
 
   // Public API
   bool        openFile(const std::string& filepath);
-  bool        loadFromLines(std::vector<std::string>&& lines);
+  // Takes a program from the CAM view and previews it at once
+  bool        loadProgram(std::shared_ptr<const Program> program);
   std::string getFilename() const;
-  const std::vector<std::string>& getLines() const;
-  bool                            parseTimer();
+  bool        empty() const;
+  // What to stream to the controller, starting at line `first` of a file or
+  // step `first` of a program (preview paths keep the index of their rapid)
+  std::vector<std::string> linesFrom(size_t first = 0) const;
+  // The loaded program; null for a file
+  const Program*           getProgram() const { return m_program.get(); }
+  bool                     parseTimer();
 
 private:
   // Application context
   NcApp*         m_app;
   NcControlView* m_view;
 
-  // G-code line storage (always populated after open/load)
-  std::vector<std::string> m_lines;
+  // G-code line storage, or the program when loaded from the CAM view
+  std::vector<std::string>       m_lines;
+  std::shared_ptr<const Program> m_program;
   size_t                   m_line_index = 0;
 
   // G-code file state
@@ -53,6 +62,8 @@ private:
   unsigned long m_line_count = 0;
   unsigned long m_lines_consumed = 0;
   unsigned long m_last_rapid_line = 0;
+  // Last programmed position, negated like the parsed points
+  Point2d       m_position = { 0.0, 0.0 };
 
   // Path data
   GPath              m_current_path;
@@ -60,6 +71,14 @@ private:
 
   // Private helper methods
   nlohmann::json parseLine(const std::string& line);
+  // Appends an arc from the current path's last point to `end` about
+  // `center`, flattened for display
+  void           pushArcPoints(Point2d end, Point2d center, bool ccw);
+  // Ends the current preview path with a rapid to `to`, which starts the
+  // next one
+  void           previewRapid(Point2d to);
+  // Pushes the last preview path and shows them all
+  void           finishPreview();
   void           pushCurrentPathToViewer(int rapid_line);
   void           resetParseState();
 };
@@ -387,6 +387,15 @@ void NcHmi::getBoundingBox(Point2d* bbox_min, Point2d* bbox_max)
   if (!m_app)
     return;
   auto& control_view = m_app->getControlView();
+  // A program from the CAM view knows its extents, arcs included
+  if (const Program* program = control_view.getGCode().getProgram()) {
+    const auto& work_offset = control_view.m_machine_parameters.work_offset;
+    *bbox_min = { program->bbox.min.x - work_offset[0],
+                  program->bbox.min.y - work_offset[1] };
+    *bbox_max = { program->bbox.max.x - work_offset[0],
+                  program->bbox.max.y - work_offset[1] };
+    return;
+  }
   auto& stack = m_app->getRenderer().getPrimitiveStack();
   bbox_max->x = std::numeric_limits<int>::min();
   bbox_max->y = std::numeric_limits<int>::min();
@@ -544,11 +553,9 @@ void NcHmi::handleButton(const std::string& id)
         case HmiButtonId::Run: {
           LOG_F(INFO, "Clicked Run");
           if (checkPathBounds()) {
-            const auto& lines = control_view.getGCode().getLines();
-            if (!lines.empty()) {
+            if (!control_view.getGCode().empty()) {
               auto do_run = [&control_view]() {
-                const auto& l = control_view.getGCode().getLines();
-                for (const auto& line : l) {
+                for (const auto& line : control_view.getGCode().linesFrom()) {
                   control_view.m_motion_controller->pushGCode(line);
                 }
                 control_view.m_motion_controller->runStack();
@@ -599,9 +606,8 @@ void NcHmi::handleButton(const std::string& id)
         case HmiButtonId::TestRun: {
           LOG_F(INFO, "Clicked Test Run");
           if (checkPathBounds()) {
-            const auto& lines = control_view.getGCode().getLines();
-            if (!lines.empty()) {
-              for (const auto& line : lines) {
+            if (!control_view.getGCode().empty()) {
+              for (const auto& line : control_view.getGCode().linesFrom()) {
                 if (line.find("fire_torch") != std::string::npos) {
                   std::string modified = line;
                   removeSubstrs(modified, "fire_torch");
@@ -759,13 +765,12 @@ void NcHmi::jumpin(Primitive* p)
     return;
   auto& control_view = m_app->getControlView();
   if (checkPathBounds()) {
-    const auto& lines = control_view.getGCode().getLines();
-    if (!lines.empty()) {
+    if (!control_view.getGCode().empty()) {
       int           rapid_line = std::get<int>(p->user_data);
       unsigned long start =
         (rapid_line > 0) ? static_cast<unsigned long>(rapid_line) : 0;
-      for (unsigned long i = start; i < lines.size(); i++) {
-        control_view.m_motion_controller->pushGCode(lines[i]);
+      for (const auto& line : control_view.getGCode().linesFrom(start)) {
+        control_view.m_motion_controller->pushGCode(line);
       }
       control_view.m_motion_controller->runStack();
     }
@@ -0,0 +1,55 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned threads)
+{
+  threads = std::max(threads, 1u);
+  m_threads.reserve(threads);
+  for (unsigned i = 0; i < threads; i++)
+    m_threads.emplace_back(&WorkerPool::run, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard lock(m_mutex);
+    m_stop = true;
+    m_jobs.clear();
+  }
+  m_wake.notify_all();
+  for (auto& thread : m_threads)
+    thread.join();
+}
+
+void WorkerPool::submit(std::function<void()> job)
+{
+  {
+    std::lock_guard lock(m_mutex);
+    m_jobs.push_back(std::move(job));
+  }
+  m_wake.notify_one();
+}
+
+WorkerPool& WorkerPool::background()
+{
+  static WorkerPool pool(
+    std::clamp(std::thread::hardware_concurrency(), 2u, 5u) - 1);
+  return pool;
+}
+
+void WorkerPool::run()
+{
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock lock(m_mutex);
+      m_wake.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+      if (m_stop)
+        return;
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+    job();
+  }
+}
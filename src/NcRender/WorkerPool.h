@@ -0,0 +1,36 @@
+#ifndef WORKER_POOL_
+#define WORKER_POOL_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads running submitted jobs in FIFO order. Jobs still queued
+// when the pool is destroyed are dropped; running ones are waited for.
+class WorkerPool {
+public:
+  explicit WorkerPool(unsigned threads);
+  ~WorkerPool();
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  void submit(std::function<void()> job);
+
+  // Shared pool for background geometry work (toolpath builds), sized to
+  // leave a core for the render thread
+  static WorkerPool& background();
+
+private:
+  std::mutex                        m_mutex;
+  std::condition_variable           m_wake;
+  std::deque<std::function<void()>> m_jobs;
+  std::vector<std::thread>          m_threads;
+  bool                              m_stop = false;
+
+  void run();
+};
+
+#endif // WORKER_POOL_
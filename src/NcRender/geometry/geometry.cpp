@@ -2,6 +2,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <limits>
+#include <numbers>
 #include <stdexcept>
 #include <stdio.h>
 #include <stdlib.h>
@@ -70,6 +71,26 @@ Point2d rotatePoint(Point2d center, Point2d point, double angle)
   return return_point;
 }
 
+void transformPoints(const std::vector<Point2d>& in,
+                     std::vector<Point2d>&       out,
+                     double                      angle,
+                     double                      scale,
+                     Point2d                     translation)
+{
+  // Same (single precision) trig as rotatePoint so both agree exactly
+  double       radians = (3.1415926f / 180.0f) * angle;
+  const double c = cosf(radians) * scale;
+  const double s = sinf(radians) * scale;
+  out.resize(in.size());
+  const Point2d* src = in.data();
+  Point2d*       dst = out.data();
+  for (size_t i = 0, n = in.size(); i < n; i++) {
+    const double x = src[i].x, y = src[i].y;
+    dst[i].x = c * x + s * y + translation.x;
+    dst[i].y = c * y - s * x + translation.y;
+  }
+}
+
 Point2d mirrorPoint(Point2d point, const Line& line)
 {
   double  dx, dy, a, b, x, y;
@@ -577,6 +598,100 @@ double measureArcCircumference(double start_angle, double end_angle, double radi
  * INTERSECTION TESTS
  **********************/
 
+// Whether path[i] .. path[j] follow one circle within `tolerance`: every
+// vertex and the middle of every segment within it of the circle through
+// path[i], the middle vertex and path[j], no segment turning more than 15
+// degrees about the centre, all turning one way and short of a full turn.
+// Checking the middles keeps coarse segments, whose chords sag away from
+// the circle even with their ends on it, as lines. The step limit keeps
+// drawn polygons (fewer than 24 sides to the turn) from being rounded off;
+// finer steps are a tessellated curve the arc restores. Fills in the arc
+// move if so.
+static bool fitArc(const Path& path,
+                   size_t      i,
+                   size_t      j,
+                   double      tolerance,
+                   ArcMove*    out)
+{
+  const Point2d& a = path[i];
+  const Point2d& m = path[(i + j) / 2];
+  const Point2d& b = path[j];
+  const double   turn = (m.x - a.x) * (b.y - m.y) - (m.y - a.y) * (b.x - m.x);
+  if (std::fabs(turn) < 1e-12)
+    return false;
+  const Point2d center = threePointCircleCenter(a, m, b);
+  const double  radius = distance(center, a);
+
+  constexpr double max_step = std::numbers::pi / 12;
+  double           sweep = 0.0;
+  for (size_t k = i; k < j; k++) {
+    const Point2d& p = path[k];
+    const Point2d& q = path[k + 1];
+    const Point2d  mid = { (p.x + q.x) / 2, (p.y + q.y) / 2 };
+    if (std::fabs(distance(center, q) - radius) > tolerance ||
+        std::fabs(distance(center, mid) - radius) > tolerance)
+      return false;
+    const double px = p.x - center.x, py = p.y - center.y;
+    const double qx = q.x - center.x, qy = q.y - center.y;
+    const double step = std::atan2(px * qy - py * qx, px * qx + py * qy);
+    if (step * turn <= 0.0 || std::fabs(step) > max_step)
+      return false;
+    sweep += step;
+  }
+  if (std::fabs(sweep) > 2.0 * std::numbers::pi - 1e-3)
+    return false;
+
+  out->end = b;
+  out->is_arc = true;
+  out->center = center;
+  out->ccw = sweep > 0.0;
+  return true;
+}
+
+std::vector<ArcMove> fitArcs(const Path& path,
+                             size_t      first,
+                             size_t      last,
+                             double      tolerance)
+{
+  std::vector<ArcMove> moves;
+  size_t               i = first;
+  while (i < last) {
+    // Grow the arc from path[i] for as long as it still fits
+    ArcMove arc;
+    size_t  arc_end = i;
+    if (tolerance > 0.0) {
+      for (size_t j = i + 3; j <= last; j++) {
+        ArcMove longer;
+        if (!fitArc(path, i, j, tolerance, &longer))
+          break;
+        arc = longer;
+        arc_end = j;
+      }
+    }
+    // Straight to within the tolerance: leave it to lines
+    double deviation = 0.0;
+    if (arc_end > i) {
+      const Point2d& a = path[i];
+      const Point2d& b = path[arc_end];
+      const double   chord = distance(a, b);
+      for (size_t k = i + 1; k < arc_end; k++) {
+        const double cross = (b.x - a.x) * (path[k].y - a.y) -
+                             (b.y - a.y) * (path[k].x - a.x);
+        deviation = std::max(deviation, std::fabs(cross) / chord);
+      }
+    }
+    if (arc_end > i && deviation > tolerance) {
+      moves.push_back(arc);
+      i = arc_end;
+    }
+    else {
+      moves.push_back({ path[i + 1] });
+      i++;
+    }
+  }
+  return moves;
+}
+
 bool linesIntersect(const Line& l1, const Line& l2)
 {
   Point2d p1 = l1.start;
@@ -635,38 +750,22 @@ bool lineIntersectsWithCircle(const Line& l, Point2d center, double radius)
   return false;
 }
 
-static bool pointInPolygon(int                 polyCorners,
-                           std::vector<double> polyX,
-                           std::vector<double> polyY,
-                           double              x,
-                           double              y)
-{
-  int  i;
-  int  j = polyCorners - 1;
-  bool oddNodes = false;
-  for (i = 0; i < polyCorners; i++) {
-    if (((polyY[i] < y && polyY[j] >= y) || (polyY[j] < y && polyY[i] >= y)) &&
-        (polyX[i] <= x || polyX[j] <= x)) {
-      oddNodes ^= (polyX[i] + (y - polyY[i]) / (polyY[j] - polyY[i]) *
-                                (polyX[j] - polyX[i]) <
-                   x);
-    }
-    j = i;
-  }
-  return oddNodes;
-}
-
+// Even-odd crossing test, read straight off the points: lead placement and
+// cut sequencing run it in their inner loops
 bool pointIsInsidePolygon(const Path& polygon, Point2d point)
 {
-  std::vector<double> polyX;
-  std::vector<double> polyY;
-
-  for (const auto& pt : polygon) {
-    polyX.push_back(pt.x);
-    polyY.push_back(pt.y);
+  const double x = point.x;
+  const double y = point.y;
+  bool         odd_nodes = false;
+  for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+    const Point2d& a = polygon[i];
+    const Point2d& b = polygon[j];
+    if (((a.y < y && b.y >= y) || (b.y < y && a.y >= y)) &&
+        (a.x <= x || b.x <= x)) {
+      odd_nodes ^= (a.x + (y - a.y) / (b.y - a.y) * (b.x - a.x) < x);
+    }
   }
-
-  return pointInPolygon(polyX.size(), polyX, polyY, point.x, point.y);
+  return odd_nodes;
 }
 
 bool polygonIsInsidePolygon(const Path& polygon1, const Path& polygon2)
@@ -852,6 +951,59 @@ bool longestStraightRun(const Path&  path,
   return found;
 }
 
+bool straightRunThrough(const Path&  path,
+                        size_t       index,
+                        double       min_length,
+                        double       dev_tolerance,
+                        StraightRun* out)
+{
+  const size_t n = path.size();
+  if (n < 3 || index >= n || out == nullptr)
+    return false;
+
+  // Whether every vertex strictly between i and j lies within the tolerance
+  // of the chord (path[i], path[j])
+  auto straight = [&](size_t i, size_t j) {
+    const double dx = path[j].x - path[i].x;
+    const double dy = path[j].y - path[i].y;
+    const double chord_len = std::sqrt(dx * dx + dy * dy);
+    if (chord_len < 1e-9)
+      return false;
+    for (size_t k = (i + 1) % n; k != j; k = (k + 1) % n) {
+      const double pvx = path[k].x - path[i].x;
+      const double pvy = path[k].y - path[i].y;
+      if (std::fabs(dx * pvy - dy * pvx) / chord_len > dev_tolerance)
+        return false;
+    }
+    return true;
+  };
+
+  size_t start = index;
+  size_t end = (index + 1) % n;
+  size_t edges = 1;
+  for (bool grew = true; grew && edges < n - 1;) {
+    grew = false;
+    if (straight(start, (end + 1) % n)) {
+      end = (end + 1) % n;
+      edges++;
+      grew = true;
+    }
+    if (edges < n - 1 && straight((start + n - 1) % n, end)) {
+      start = (start + n - 1) % n;
+      edges++;
+      grew = true;
+    }
+  }
+
+  const double chord_len = distance(path[start], path[end]);
+  if (chord_len < min_length || chord_len < 1e-9)
+    return false;
+  out->start = start;
+  out->end = end;
+  out->chord_length = chord_len;
+  return true;
+}
+
 std::vector<Point2d> buildArcLead(Point2d attach,
                                   Point2d tangent_dir,
                                   double  radius,
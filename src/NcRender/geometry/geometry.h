@@ -77,6 +77,14 @@ Point2d midpoint(Point2d p1, Point2d p2);
 // Geometric transformations
 Point2d rotatePoint(Point2d center, Point2d point, double angle);
 Point2d mirrorPoint(Point2d point, const Line& line);
+// Batched rotatePoint() about the origin followed by `scale` and a move by
+// `translation`: out[i] = R(angle) * in[i] * scale + translation. One sin/cos
+// for the whole batch; the loop is branch-free so it vectorizes.
+void    transformPoints(const std::vector<Point2d>& in,
+                        std::vector<Point2d>&       out,
+                        double                      angle,
+                        double                      scale,
+                        Point2d                     translation);
 
 // Geometric conversions (proper typed versions)
 std::vector<Line> arcToLineSegments(const Arc& arc, int num_segments = 100);
@@ -143,6 +151,16 @@ bool longestStraightRun(const Path&  path,
                         double       dev_tolerance,
                         StraightRun* out);
 
+// Grow a straight run both ways from the edge leaving vertex `index` of a
+// closed contour, one vertex per side in turn, as long as it stays within
+// dev_tolerance. Returns true and fills `out` if its chord length is
+// >= min_length.
+bool straightRunThrough(const Path&  path,
+                        size_t       index,
+                        double       min_length,
+                        double       dev_tolerance,
+                        StraightRun* out);
+
 // Build a 2D arc lead polyline that ends exactly at `attach`, tangent
 // to `tangent_dir`. sweep_sign = +1 sweeps CCW, -1 sweeps CW. Last
 // vertex is snapped to `attach` to avoid sub-ULP seam vertices.
@@ -153,6 +171,25 @@ std::vector<Point2d> buildArcLead(Point2d attach,
                                   int     sweep_sign,
                                   int     segments = 16);
 
+// One move of a polyline rewritten with arcs: straight to `end`, or along a
+// circular arc about `center`, counter-clockwise if `ccw`, ending at `end`
+struct ArcMove {
+  Point2d end;
+  bool    is_arc = false;
+  Point2d center = { 0.0, 0.0 };
+  bool    ccw = false;
+};
+
+// Rewrites path[first] .. path[last] as moves starting from path[first],
+// replacing runs of three or more segments whose vertices and midpoints lie
+// on one circle to within `tolerance`, each turning at most 15 degrees, by
+// an arc. Runs that are straight to within the tolerance and full circles
+// are left as lines. tolerance <= 0 gives one line per segment.
+std::vector<ArcMove> fitArcs(const Path& path,
+                             size_t      first,
+                             size_t      last,
+                             double      tolerance);
+
 // Intersection tests
 bool linesIntersect(const Line& l1, const Line& l2);
 bool lineIntersectsWithCircle(const Line& l, Point2d center, double radius);
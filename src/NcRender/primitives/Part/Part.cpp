@@ -3,6 +3,7 @@
 #include "../../geometry/geometry.h"
 
 #include <NcRender/NcRender.h>
+#include <NcRender/WorkerPool.h>
 
 #include <loguru.hpp>
 
@@ -11,6 +12,7 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <numeric>
 #include <optional>
 
 std::string Part::getTypeName() { return "part"; }
@@ -256,212 +258,7 @@ void Part::simplify(const std::vector<Point2d>& pointList,
 }
 void Part::render()
 {
-  if (!(m_last_control == m_control)) {
-    bool smoothing_changed = m_last_control.smoothing != m_control.smoothing;
-
-    m_number_of_verticies = 0;
-    m_tool_paths.clear();
-    m_tool_path_arrows.clear();
-
-    // Build small V-shaped direction arrows along a toolpath's contour proper
-    // (clear of the lead-in / lead-out), indicating cut direction. Mirrors the
-    // control view's gcode arrows (gcode.cpp). One arrow per ~arrow_spacing of
-    // travel, at least one. Both lengths are in built-point space (scaled by
-    // m_control.scale) so they track the geometry.
-    const double arrow_len = 2.0 * m_control.scale;
-    const double arrow_spacing = 20.0 * m_control.scale;
-    auto build_arrows =
-      [arrow_len, arrow_spacing](
-        const Toolpath& tp) -> std::vector<std::vector<Point2d>> {
-      const size_t n = tp.points.size();
-      if (n < 2)
-        return {};
-      const size_t cfirst = std::min(tp.lead_in_count, n - 1);
-      const size_t clast =
-        (tp.lead_out_count < n) ? (n - 1 - tp.lead_out_count) : (n - 1);
-      if (clast <= cfirst)
-        return {};
-
-      // Cumulative arc length across the contour-proper segments. cum[k] is the
-      // distance from cfirst to vertex cfirst+k.
-      const size_t        seg_count = clast - cfirst;
-      std::vector<double> cum(seg_count + 1, 0.0);
-      for (size_t k = 0; k < seg_count; ++k)
-        cum[k + 1] = cum[k] + geo::distance(tp.points[cfirst + k],
-                                            tp.points[cfirst + k + 1]);
-      const double total = cum[seg_count];
-      if (total <= 0.0)
-        return {};
-
-      // Divide the contour into `count` equal spans and drop an arrow at each
-      // span's centre, so arrows sit ~arrow_spacing apart and clear of the ends.
-      const long count = std::max<long>(1, std::lround(total / arrow_spacing));
-      const double step = total / static_cast<double>(count);
-
-      std::vector<std::vector<Point2d>> arrows;
-      arrows.reserve(count);
-      size_t seg = 0;
-      for (long a = 0; a < count; ++a) {
-        const double target = (static_cast<double>(a) + 0.5) * step;
-        while (seg + 1 < seg_count && cum[seg + 1] < target)
-          ++seg;
-        const Point2d& pa = tp.points[cfirst + seg];
-        const Point2d& pb = tp.points[cfirst + seg + 1];
-        const double   seg_len = cum[seg + 1] - cum[seg];
-        const double   t = seg_len > 0.0 ? (target - cum[seg]) / seg_len : 0.0;
-        const Point2d  apex = { pa.x + (pb.x - pa.x) * t,
-                                pa.y + (pb.y - pa.y) * t };
-        const double   angle = geo::measurePolarAngle(pb, pa);
-        const Point2d p1 = geo::createPolarLine(apex, angle + 30, arrow_len).end;
-        const Point2d p2 = geo::createPolarLine(apex, angle - 30, arrow_len).end;
-        arrows.push_back({ p1, apex, p2 });
-      }
-      return arrows;
-    };
-
-    for (auto& [layer_name, layer] : m_layers) {
-      // Skip invisible layers
-      if (!layer.visible)
-        continue;
-
-      for (auto& path : layer.paths) {
-        path.built_points.clear();
-        try {
-          // Only re-simplify when smoothing changed or first build
-          if (smoothing_changed || path.simplified_points.empty()) {
-            path.simplified_points.clear();
-            // For closed paths with very few points, skip simplification to
-            // preserve geometry
-            if (path.is_closed && path.points.size() <= 6) {
-              path.simplified_points = path.points;
-            }
-            else {
-              simplify(
-                path.points, path.simplified_points, m_control.smoothing);
-            }
-          }
-
-          // Transform cached simplified points
-          for (size_t i = 0; i < path.simplified_points.size(); i++) {
-            Point2d rotated = geo::rotatePoint(
-              { 0, 0 }, path.simplified_points[i], m_control.angle);
-            path.built_points.push_back(
-              { (rotated.x + m_control.offset.x) * m_control.scale,
-                (rotated.y + m_control.offset.y) * m_control.scale });
-            m_number_of_verticies++;
-          }
-          path.bbox = geo::calculateBoundingBox(path.built_points);
-          if (layer.toolpath_visible == true) {
-            if (path.is_closed == true) {
-              // Need at least 3 points to form a valid closed polygon
-              if (path.built_points.size() < 3) {
-                continue;
-              }
-              // Lead-IN is sized by lead_in_length for BOTH inside and
-              // outside contours; createToolpathLeads applies the
-              // lead_out_length as a real lead-out on outside contours only.
-              const int base_direction = path.is_inside_contour ? -1 : +1;
-              std::vector<std::vector<Point2d>> tpaths = offsetPath(
-                path.built_points,
-                base_direction * (double) fabs(layer.toolpath_offset));
-
-              // A single source contour can offset into MORE than one polygon.
-              // When the kerf offset is large relative to thin features (e.g. a
-              // narrow slot or sliver, or the whole part scaled down), the
-              // offset self-intersects and Clipper emits, alongside the primary
-              // boundary, one or more polygons of OPPOSITE winding: voids
-              // trapped inside the material (outside source) or islands of
-              // material (inside source). These flip the inside/outside sense,
-              // so each result polygon must be classified by its OWN winding
-              // rather than inheriting the source path's -- otherwise a trapped
-              // void gets an outside-style lead-in/lead-out cut into finished
-              // material. Clipper canonicalizes winding and the outermost
-              // boundary encloses the rest, so the largest-|area| polygon is
-              // nesting depth 0; a polygon whose winding is opposite to it sits
-              // at odd depth and flips the source inside/outside flag (this XOR
-              // composes correctly through any nesting depth).
-              // A contour can also offset away to nothing (e.g. a small hole
-              // shrunk past its inradius), leaving no polygons -- skip it.
-              if (tpaths.empty())
-                continue;
-              std::vector<double> tp_area(tpaths.size(), 0.0);
-              size_t              dominant = 0;
-              for (size_t x = 0; x < tpaths.size(); x++) {
-                tp_area[x] = geo::signedPolygonArea(tpaths[x]);
-                if (std::fabs(tp_area[x]) > std::fabs(tp_area[dominant]))
-                  dominant = x;
-              }
-              const bool dominant_positive = tp_area[dominant] >= 0.0;
-
-              for (size_t x = 0; x < tpaths.size(); x++) {
-                const bool opposite_winding =
-                  (tp_area[x] >= 0.0) != dominant_positive;
-                const bool tp_is_inside =
-                  path.is_inside_contour != opposite_winding;
-                const int direction = tp_is_inside ? -1 : +1;
-
-                // Default cut direction, for plasma cut quality. The right-hand
-                // side of a plasma kerf comes out square while the left side
-                // bevels, so we keep the finished part on the square side by
-                // running OUTSIDE (external) profiles clockwise and INSIDE
-                // (holes) counter-clockwise -- the same alternation SheetCam
-                // applies automatically. signedPolygonArea is +ve for CCW, -ve
-                // for CW; built-point space is Y-up and the emitter's X/Y
-                // negation is a 180 deg rotation that preserves winding, so this
-                // winding reaches the machine unchanged. Clipper canonicalizes
-                // its own output winding, so normalize explicitly here rather
-                // than rely on it.
-                const bool want_ccw = tp_is_inside; // hole -> CCW, profile -> CW
-                if ((geo::signedPolygonArea(tpaths[x]) >= 0.0) != want_ccw)
-                  std::reverse(tpaths[x].begin(), tpaths[x].end());
-
-                // Manual override (CAM context menu "Reverse Direction") flips
-                // the default winding. Must happen AFTER offsetPath/normalize;
-                // createToolpathLeads then derives a valid
-                // lead-in/lead-out/overburn for the resulting direction.
-                if (path.reversed)
-                  std::reverse(tpaths[x].begin(), tpaths[x].end());
-                Toolpath tp;
-                if (createToolpathLeads(&tp,
-                                        tpaths[x],
-                                        m_control.lead_in_length,
-                                        m_control.lead_out_length,
-                                        direction)) {
-                  tp.is_closed_contour = true;
-                  tp.is_inside_contour = tp_is_inside;
-                  tp.kerf_width = std::fabs(layer.toolpath_offset) * 2.0;
-                  for (auto& arrow : build_arrows(tp))
-                    m_tool_path_arrows.push_back(std::move(arrow));
-                  m_tool_paths.push_back(std::move(tp));
-                }
-              }
-            }
-            else {
-              Toolpath tp;
-              tp.points = path.built_points;
-              if (path.reversed)
-                std::reverse(tp.points.begin(), tp.points.end());
-              tp.is_closed_contour = false;
-              tp.is_inside_contour = false;
-              tp.kerf_width = std::fabs(layer.toolpath_offset) * 2.0;
-              for (auto& arrow : build_arrows(tp))
-                m_tool_path_arrows.push_back(std::move(arrow));
-              m_tool_paths.push_back(std::move(tp));
-            }
-          }
-        }
-        catch (std::exception& e) {
-          LOG_F(ERROR,
-                "(Part::render) Exception: %s, setting visability "
-                "to false to avoid further exceptions!",
-                e.what());
-          visible = false;
-        }
-      }
-    }
-    getBoundingBox(&m_bb_min, &m_bb_max);
-  }
-  m_last_control = m_control;
+  syncToolpaths();
   glPushMatrix();
   glTranslatef(offset[0], offset[1], offset[2]);
   glScalef(scale, scale, scale);
@@ -494,6 +291,9 @@ void Part::render()
   // With kerf-width display on, each sub-strip is stroked into a filled swath
   // of the actual kerf (in built-point space, so it scales with zoom); inner
   // edge sits on the finished contour, outer edge half a kerf into the scrap.
+  // Until a pending build lands, the previous toolpaths draw at reduced
+  // alpha to show they are out of date
+  const float    build_alpha = m_build_pending ? 0.35f : 1.0f;
   const Color4f* cut_c = m_toolpath_cut_color;
   const Color4f* lead_c = m_toolpath_lead_color;
   for (auto& tp : m_tool_paths) {
@@ -513,7 +313,7 @@ void Part::render()
     auto draw_strip = [&](size_t first, size_t last, const Color4f* c) {
       if (last <= first)
         return;
-      glColor4f(c->r, c->g, c->b, c->a);
+      glColor4f(c->r, c->g, c->b, c->a * build_alpha);
       glVertexPointer(2, GL_DOUBLE, sizeof(Point2d), pts + first);
       glDrawArrays(GL_LINE_STRIP, 0, last - first + 1);
     };
@@ -566,7 +366,7 @@ void Part::render()
         m_ribbon_buf.push_back(
           { pts[i].x - nrm.x * scale, pts[i].y - nrm.y * scale });
       }
-      glColor4f(c->r, c->g, c->b, c->a);
+      glColor4f(c->r, c->g, c->b, c->a * build_alpha);
       glVertexPointer(2, GL_DOUBLE, sizeof(Point2d), m_ribbon_buf.data());
       glDrawArrays(GL_TRIANGLE_STRIP, 0, m_ribbon_buf.size());
     };
@@ -589,7 +389,7 @@ void Part::render()
   }
   // Cut-direction arrows over the toolpaths.
   const Color4f* arrow_c = m_toolpath_arrow_color;
-  glColor4f(arrow_c->r, arrow_c->g, arrow_c->b, arrow_c->a);
+  glColor4f(arrow_c->r, arrow_c->g, arrow_c->b, arrow_c->a * build_alpha);
   for (auto& arrow : m_tool_path_arrows) {
     if (arrow.empty())
       continue;
@@ -602,6 +402,413 @@ void Part::render()
   glPopMatrix();
 }
 
+namespace {
+
+// Hands out m_toolpaths_stamp values, unique across all parts
+uint64_t nextToolpathsStamp()
+{
+  static std::atomic<uint64_t> stamp{ 0 };
+  return ++stamp;
+}
+
+// Build small V-shaped direction arrows along a toolpath's contour proper
+// (clear of the lead-in / lead-out), indicating cut direction. Mirrors the
+// control view's gcode arrows (gcode.cpp). One arrow per ~arrow_spacing of
+// travel, at least one. Both lengths are in built-point space (scaled by
+// `scale`) so they track the geometry.
+std::vector<std::vector<Point2d>> buildArrows(const Part::Toolpath& tp,
+                                              double             scale)
+{
+  const double arrow_len = 2.0 * scale;
+  const double arrow_spacing = 20.0 * scale;
+  const size_t n = tp.points.size();
+  if (n < 2)
+    return {};
+  const size_t cfirst = std::min(tp.lead_in_count, n - 1);
+  const size_t clast =
+    (tp.lead_out_count < n) ? (n - 1 - tp.lead_out_count) : (n - 1);
+  if (clast <= cfirst)
+    return {};
+
+  // Cumulative arc length across the contour-proper segments. cum[k] is the
+  // distance from cfirst to vertex cfirst+k.
+  const size_t        seg_count = clast - cfirst;
+  std::vector<double> cum(seg_count + 1, 0.0);
+  for (size_t k = 0; k < seg_count; ++k)
+    cum[k + 1] = cum[k] + geo::distance(tp.points[cfirst + k],
+                                        tp.points[cfirst + k + 1]);
+  const double total = cum[seg_count];
+  if (total <= 0.0)
+    return {};
+
+  // Divide the contour into `count` equal spans and drop an arrow at each
+  // span's centre, so arrows sit ~arrow_spacing apart and clear of the ends.
+  const long count = std::max<long>(1, std::lround(total / arrow_spacing));
+  const double step = total / static_cast<double>(count);
+
+  std::vector<std::vector<Point2d>> arrows;
+  arrows.reserve(count);
+  size_t seg = 0;
+  for (long a = 0; a < count; ++a) {
+    const double target = (static_cast<double>(a) + 0.5) * step;
+    while (seg + 1 < seg_count && cum[seg + 1] < target)
+      ++seg;
+    const Point2d& pa = tp.points[cfirst + seg];
+    const Point2d& pb = tp.points[cfirst + seg + 1];
+    const double   seg_len = cum[seg + 1] - cum[seg];
+    const double   t = seg_len > 0.0 ? (target - cum[seg]) / seg_len : 0.0;
+    const Point2d  apex = { pa.x + (pb.x - pa.x) * t,
+                            pa.y + (pb.y - pa.y) * t };
+    const double   angle = geo::measurePolarAngle(pb, pa);
+    const Point2d p1 = geo::createPolarLine(apex, angle + 30, arrow_len).end;
+    const Point2d p2 = geo::createPolarLine(apex, angle - 30, arrow_len).end;
+    arrows.push_back({ p1, apex, p2 });
+  }
+  return arrows;
+}
+
+} // namespace
+
+std::shared_ptr<const Part::LocalToolpaths>
+Part::buildLocalToolpaths(const BuildPath&           path,
+                          const ToolpathKey&         key,
+                          const part_control_data_t& control)
+{
+  auto local_toolpaths = std::make_shared<LocalToolpaths>();
+  local_toolpaths->key = key;
+  const double         kerf_offset = key.kerf;
+  std::vector<Point2d> local;
+  geo::transformPoints(
+    *path.simplified_points, local, 0.0, control.scale, { 0.0, 0.0 });
+
+  if (!path.is_closed) {
+    Toolpath tp;
+    tp.points = std::move(local);
+    if (path.reversed)
+      std::reverse(tp.points.begin(), tp.points.end());
+    tp.is_closed_contour = false;
+    tp.is_inside_contour = false;
+    tp.kerf_width = kerf_offset * 2.0;
+    for (auto& arrow : buildArrows(tp, control.scale))
+      local_toolpaths->arrows.push_back(std::move(arrow));
+    local_toolpaths->toolpaths.push_back(std::move(tp));
+    return local_toolpaths;
+  }
+
+  // Lead-IN is sized by lead_in_length for BOTH inside and outside contours;
+  // createToolpathLeads applies the lead_out_length as a real lead-out on
+  // outside contours only.
+  const int base_direction = path.is_inside_contour ? -1 : +1;
+  std::vector<std::vector<Point2d>> tpaths =
+    offsetPath(local, base_direction * kerf_offset);
+
+  // A single source contour can offset into MORE than one polygon. When the
+  // kerf offset is large relative to thin features (e.g. a narrow slot or
+  // sliver, or the whole part scaled down), the offset self-intersects and
+  // Clipper emits, alongside the primary boundary, one or more polygons of
+  // OPPOSITE winding: voids trapped inside the material (outside source) or
+  // islands of material (inside source). These flip the inside/outside sense,
+  // so each result polygon must be classified by its OWN winding rather than
+  // inheriting the source path's -- otherwise a trapped void gets an
+  // outside-style lead-in/lead-out cut into finished material. Clipper
+  // canonicalizes winding and the outermost boundary encloses the rest, so the
+  // largest-|area| polygon is nesting depth 0; a polygon whose winding is
+  // opposite to it sits at odd depth and flips the source inside/outside flag
+  // (this XOR composes correctly through any nesting depth). A contour can also
+  // offset away to nothing (e.g. a small hole shrunk past its inradius),
+  // leaving no polygons -- skip it.
+  if (tpaths.empty())
+    return local_toolpaths;
+  std::vector<double> tp_area(tpaths.size(), 0.0);
+  size_t              dominant = 0;
+  for (size_t x = 0; x < tpaths.size(); x++) {
+    tp_area[x] = geo::signedPolygonArea(tpaths[x]);
+    if (std::fabs(tp_area[x]) > std::fabs(tp_area[dominant]))
+      dominant = x;
+  }
+  const bool dominant_positive = tp_area[dominant] >= 0.0;
+
+  for (size_t x = 0; x < tpaths.size(); x++) {
+    const bool opposite_winding = (tp_area[x] >= 0.0) != dominant_positive;
+    const bool tp_is_inside = path.is_inside_contour != opposite_winding;
+    const int direction = tp_is_inside ? -1 : +1;
+
+    // Default cut direction, for plasma cut quality. The right-hand side of a
+    // plasma kerf comes out square while the left side bevels, so we keep the
+    // finished part on the square side by running OUTSIDE (external) profiles
+    // clockwise and INSIDE (holes) counter-clockwise -- the same alternation
+    // SheetCam applies automatically. signedPolygonArea is +ve for CCW, -ve for
+    // CW; built-point space is Y-up and the emitter's X/Y negation is a 180 deg
+    // rotation that preserves winding, so this winding reaches the machine
+    // unchanged. Clipper canonicalizes its own output winding, so normalize
+    // explicitly here rather than rely on it.
+    const bool want_ccw = tp_is_inside; // hole -> CCW, profile -> CW
+    if ((geo::signedPolygonArea(tpaths[x]) >= 0.0) != want_ccw)
+      std::reverse(tpaths[x].begin(), tpaths[x].end());
+
+    // Manual override (CAM context menu "Reverse Direction") flips the default
+    // winding. Must happen AFTER offsetPath/normalize; createToolpathLeads then
+    // derives a valid lead-in/lead-out/overburn for the resulting direction.
+    if (path.reversed)
+      std::reverse(tpaths[x].begin(), tpaths[x].end());
+    Toolpath tp;
+    if (createToolpathLeads(&tp,
+                            tpaths[x],
+                            control.lead_in_length,
+                            control.lead_out_length,
+                            direction,
+                            control.smoothing,
+                            nullptr)) {
+      tp.is_closed_contour = true;
+      tp.is_inside_contour = tp_is_inside;
+      tp.kerf_width = kerf_offset * 2.0;
+      for (auto& arrow : buildArrows(tp, control.scale))
+        local_toolpaths->arrows.push_back(std::move(arrow));
+      local_toolpaths->toolpaths.push_back(std::move(tp));
+    }
+  }
+  return local_toolpaths;
+}
+
+bool Part::buildToolpaths(ToolpathBuild& build, const BuildState& state)
+{
+  const part_control_data_t& control = build.control;
+
+  for (auto& [layer_name, layer] : build.layers) {
+    for (auto& path : layer.paths) {
+      // Superseded by a newer build: stop, its result would be dropped
+      if (state.version.load() != build.version)
+        return false;
+      try {
+        // Only re-simplify when smoothing changed or first build; the
+        // submitter leaves the cached points out then
+        if (!path.simplified_points) {
+          auto simplified = std::make_shared<std::vector<Point2d>>();
+          // For closed paths with very few points, skip simplification to
+          // preserve geometry
+          if (path.is_closed && path.points.size() <= 6) {
+            *simplified = path.points;
+          }
+          else {
+            simplify(path.points, *simplified, control.smoothing);
+          }
+          path.simplified_points = std::move(simplified);
+        }
+
+        // Place the cached simplified points, then the toolpaths cached in
+        // part-local space: moving or rotating the part reuses them as is
+        const Point2d translation = { control.offset.x * control.scale,
+                                      control.offset.y * control.scale };
+        geo::transformPoints(*path.simplified_points,
+                             path.built_points,
+                             control.angle,
+                             control.scale,
+                             translation);
+        build.vertex_count += path.built_points.size();
+        path.bbox = geo::calculateBoundingBox(path.built_points);
+        if (!layer.toolpath_visible)
+          continue;
+        // Need at least 3 points to form a valid closed polygon
+        if (path.is_closed && path.built_points.size() < 3)
+          continue;
+
+        const ToolpathKey key = { std::fabs(layer.toolpath_offset),
+                                  control.lead_in_length,
+                                  control.lead_out_length,
+                                  control.scale,
+                                  control.smoothing,
+                                  path.reversed };
+        if (!path.local || !(path.local->key == key))
+          path.local = buildLocalToolpaths(path, key, control);
+        for (const auto& local : path.local->toolpaths) {
+          Toolpath tp = local;
+          geo::transformPoints(
+            local.points, tp.points, control.angle, 1.0, translation);
+          build.tool_paths.push_back(std::move(tp));
+        }
+        for (const auto& local : path.local->arrows) {
+          std::vector<Point2d> arrow;
+          geo::transformPoints(local, arrow, control.angle, 1.0, translation);
+          build.arrows.push_back(std::move(arrow));
+        }
+      }
+      catch (std::exception& e) {
+        LOG_F(ERROR,
+              "(Part::buildToolpaths) Exception: %s, setting visability "
+              "to false to avoid further exceptions!",
+              e.what());
+        build.failed = true;
+      }
+      catch (const char* e) {
+        // simplify() throws string literals
+        LOG_F(ERROR,
+              "(Part::buildToolpaths) Exception: %s, setting visability "
+              "to false to avoid further exceptions!",
+              e);
+        build.failed = true;
+      }
+    }
+  }
+  return true;
+}
+
+void Part::syncToolpaths()
+{
+  if (!(m_last_control == m_control)) {
+    // Moving the part only translates what is already built, which is cheap
+    // enough to do in place; anything else is rebuilt in the background
+    if (m_built && m_control.sameShape(m_last_control)) {
+      translateBuilt((m_control.offset.x - m_last_control.offset.x) *
+                       m_control.scale,
+                     (m_control.offset.y - m_last_control.offset.y) *
+                       m_control.scale);
+      getBoundingBox(&m_bb_min, &m_bb_max);
+    }
+    else {
+      submitToolpathBuild();
+    }
+  }
+  m_last_control = m_control;
+  if (m_build_pending)
+    collectToolpathBuild(false);
+}
+
+void Part::submitToolpathBuild()
+{
+  auto build = std::make_shared<ToolpathBuild>();
+  build->version = ++m_build->version;
+  build->control = m_control;
+  build->resimplify = m_simplified_smoothing != m_control.smoothing;
+  // Only the paths' flags and shared caches are taken, not their points:
+  // this runs for every control change, e.g. every frame of a rotate drag
+  for (const auto& [layer_name, layer] : m_layers) {
+    if (!layer.visible)
+      continue;
+    BuildLayer& built = build->layers[layer_name];
+    built.toolpath_offset = layer.toolpath_offset;
+    built.toolpath_visible = layer.toolpath_visible;
+    built.paths.reserve(layer.paths.size());
+    for (const auto& path : layer.paths) {
+      BuildPath& bp = built.paths.emplace_back();
+      bp.is_closed = path.is_closed;
+      bp.is_inside_contour = path.is_inside_contour;
+      bp.reversed = path.reversed;
+      bp.local = path.local;
+      if (build->resimplify || !path.simplified_points)
+        bp.points = path.points;
+      else
+        bp.simplified_points = path.simplified_points;
+    }
+  }
+  m_build_pending = true;
+
+  WorkerPool::background().submit(
+    [state = m_build, build = std::move(build)] {
+      if (state->version.load() != build->version)
+        return; // Superseded while queued
+      if (!buildToolpaths(*build, *state))
+        return;
+      std::lock_guard lock(state->mutex);
+      if (state->version.load() != build->version)
+        return;
+      state->result = std::make_unique<ToolpathBuild>(std::move(*build));
+      state->done.notify_all();
+    });
+}
+
+void Part::collectToolpathBuild(bool wait)
+{
+  std::unique_ptr<ToolpathBuild> build;
+  {
+    std::unique_lock lock(m_build->mutex);
+    if (wait) {
+      m_build->done.wait(lock, [this] {
+        return m_build->result &&
+               m_build->result->version == m_build->version.load();
+      });
+    }
+    build = std::move(m_build->result);
+  }
+  if (!build || build->version != m_build->version.load())
+    return;
+
+  // Paths only come and go together with a rebuild request, but a build
+  // whose layers no longer line up with the part must not be adopted
+  for (auto& [layer_name, built_layer] : build->layers) {
+    auto it = m_layers.find(layer_name);
+    if (it == m_layers.end() ||
+        it->second.paths.size() != built_layer.paths.size()) {
+      submitToolpathBuild();
+      return;
+    }
+  }
+  for (auto& [layer_name, built_layer] : build->layers) {
+    auto& paths = m_layers[layer_name].paths;
+    for (size_t i = 0; i < paths.size(); i++) {
+      BuildPath& built = built_layer.paths[i];
+      paths[i].simplified_points = std::move(built.simplified_points);
+      paths[i].built_points = std::move(built.built_points);
+      paths[i].bbox = built.bbox;
+      paths[i].local = std::move(built.local);
+    }
+  }
+  m_tool_paths = std::move(build->tool_paths);
+  m_tool_path_arrows = std::move(build->arrows);
+  m_toolpaths_stamp = nextToolpathsStamp();
+  m_number_of_verticies = build->vertex_count;
+  m_simplified_smoothing = build->control.smoothing;
+  if (build->failed)
+    visible = false;
+  m_build_pending = false;
+  m_built = true;
+
+  // The part may have moved since the build started
+  translateBuilt(
+    (m_control.offset.x - build->control.offset.x) * m_control.scale,
+    (m_control.offset.y - build->control.offset.y) * m_control.scale);
+  getBoundingBox(&m_bb_min, &m_bb_max);
+}
+
+void Part::finishToolpaths()
+{
+  syncToolpaths();
+  while (m_build_pending)
+    collectToolpathBuild(true);
+}
+
+void Part::translateBuilt(double dx, double dy)
+{
+  if (dx == 0.0 && dy == 0.0)
+    return;
+  for (auto& [layer_name, layer] : m_layers) {
+    if (!layer.visible)
+      continue;
+    for (auto& path : layer.paths) {
+      for (auto& p : path.built_points) {
+        p.x += dx;
+        p.y += dy;
+      }
+      path.bbox.min.x += dx;
+      path.bbox.min.y += dy;
+      path.bbox.max.x += dx;
+      path.bbox.max.y += dy;
+    }
+  }
+  for (auto& tp : m_tool_paths) {
+    for (auto& p : tp.points) {
+      p.x += dx;
+      p.y += dy;
+    }
+  }
+  m_toolpaths_stamp = nextToolpathsStamp();
+  for (auto& arrow : m_tool_path_arrows) {
+    for (auto& p : arrow) {
+      p.x += dx;
+      p.y += dy;
+    }
+  }
+}
+
 nlohmann::json Part::serialize()
 {
   nlohmann::json layers_json;
@@ -683,6 +890,7 @@ bool Part::checkIfPathIsInsidePath(std::vector<Point2d> path1,
 
 std::vector<Part::Toolpath> Part::getOrderedToolpaths()
 {
+  finishToolpaths();
   std::vector<Toolpath> toolpaths = m_tool_paths;
   std::vector<Toolpath> ret;
   if (toolpaths.size() > 0) {
@@ -828,8 +1036,15 @@ double rayPolygonClearance(const std::vector<Point2d>& poly,
 // into the body. It is also self-limiting: it never lengthens a lead past the
 // point where the pierce starts closing on a wall. Returns the pierce and the
 // attach index, or std::nullopt if no vertex can support even a minimal lead.
+//
+// With an `entry_hint`, any pierce clearing the walls by at least half the
+// best clearance will do, and the one nearest the hint wins: still well
+// inside the opening, but next to where the previous cut ended.
 std::optional<StraightLead> findStraightPierce(
-  const std::vector<Point2d>& contour, double radius, int direction)
+  const std::vector<Point2d>& contour,
+  double                      radius,
+  int                         direction,
+  const Point2d*              entry_hint)
 {
   const size_t N = contour.size();
   if (N < 3)
@@ -852,6 +1067,8 @@ std::optional<StraightLead> findStraightPierce(
   std::optional<StraightLead> best;
   double                      best_clearance = -1.0;
   double                      best_len = -1.0;
+  // Feasible leads and their pierce clearance, for the entry hint
+  std::vector<std::pair<StraightLead, double>> feasible;
 
   for (size_t i = 0; i < N; ++i) {
     const Point2d attach = contour[i];
@@ -888,6 +1105,8 @@ std::optional<StraightLead> findStraightPierce(
 
     const double pierce_clearance =
       geo::pointToPolygonDistance(contour, pierce);
+    if (entry_hint)
+      feasible.emplace_back(StraightLead{ pierce, i }, pierce_clearance);
     const bool better =
       pierce_clearance > best_clearance + tie_eps ||
       (pierce_clearance > best_clearance - tie_eps && len > best_len);
@@ -899,6 +1118,16 @@ std::optional<StraightLead> findStraightPierce(
     }
   }
 
+  if (entry_hint && best) {
+    double nearest = std::numeric_limits<double>::infinity();
+    for (const auto& [lead, clearance] : feasible) {
+      const double d = geo::distance(lead.pierce, *entry_hint);
+      if (clearance >= best_clearance * 0.5 && d < nearest) {
+        nearest = d;
+        best = lead;
+      }
+    }
+  }
   return best;
 }
 
@@ -993,7 +1222,9 @@ bool Part::createToolpathLeads(Toolpath*                   out,
                                const std::vector<Point2d>& contour_in,
                                double                      lead_in_len,
                                double                      lead_out_len,
-                               int                         direction)
+                               int                         direction,
+                               double                      smoothing,
+                               const Point2d*              entry_hint)
 {
   out->points.clear();
   out->lead_in_count = 0;
@@ -1001,6 +1232,9 @@ bool Part::createToolpathLeads(Toolpath*                   out,
   out->is_closed_contour = true;
   out->is_inside_contour = (direction < 0);
   out->lead_in_is_arc = false;
+  out->lead_in_length = lead_in_len;
+  out->lead_out_length = lead_out_len;
+  out->smoothing = smoothing;
 
   // Strip the closing-duplicate vertex that Part::offsetPath appends
   // (last == first). Working with a polygon of distinct vertices makes
@@ -1025,11 +1259,11 @@ bool Part::createToolpathLeads(Toolpath*                   out,
   const double orientation = geo::signedPolygonArea(contour) >= 0 ? 1.0 : -1.0;
 
   // Slop tolerance shared by the lead-in and lead-out side checks: RDP
-  // simplification with `m_control.smoothing` plus Clipper offset rounding /
+  // simplification with `smoothing` plus Clipper offset rounding /
   // CleanPolygons let the polygon deviate from the true contour, so allow at
   // least 0.5 mm of slop or 2x smoothing, whichever is larger.
   const double side_slop =
-    std::max(static_cast<double>(0.5), m_control.smoothing * 2.0);
+    std::max(static_cast<double>(0.5), smoothing * 2.0);
 
   // ---- Build the lead-IN --------------------------------------------------
   // Produces `lead_in_pts` (pierce -> ... -> just before attach) and the
@@ -1053,87 +1287,105 @@ bool Part::createToolpathLeads(Toolpath*                   out,
       std::max(static_cast<double>(0.5), radius_abs * 0.5);
     const double dev_tolerance =
       std::max(static_cast<double>(0.25), radius_abs * 0.1);
-    geo::StraightRun run;
-    const bool       run_found =
-      geo::longestStraightRun(contour, min_segment_len, dev_tolerance, &run);
-
-    bool arc_built = false;
-    if (run_found) {
-      // Place attach AT an actual contour vertex (mid-run by vertex index)
-      // and use the LOCAL edge direction at that vertex as the tangent, so
-      // the cut continues from arc-end into contour[mid+1] along an actual
-      // contour edge with no perpendicular jump ("spike").
-      const size_t N = contour.size();
-      const size_t run_len_verts =
-        (run.end + N - run.start) % N; // 0 disallowed (chord_len>0)
-      const size_t mid_offset = run_len_verts / 2;
-      const size_t mid = (run.start + mid_offset) % N;
-      const size_t mid_next = (mid + 1) % N;
 
+    // Tries an arc lead-in attached at contour[mid], which lies on a straight
+    // run. Place attach AT an actual contour vertex and use the LOCAL edge
+    // direction at that vertex as the tangent, so the cut continues from
+    // arc-end into contour[mid+1] along an actual contour edge with no
+    // perpendicular jump ("spike").
+    auto try_arc = [&](size_t mid) -> bool {
+      const size_t  mid_next = (mid + 1) % contour.size();
       const Point2d attach = contour[mid];
       const double  edx = contour[mid_next].x - attach.x;
       const double  edy = contour[mid_next].y - attach.y;
       const double  edge_len = std::sqrt(edx * edx + edy * edy);
-      if (edge_len > 0.0) {
-        const Point2d tangent_dir = { edx / edge_len, edy / edge_len };
-
-        // buildArcLead's sweep_sign chooses the side the arc curves toward.
-        // We want the INTERIOR side for inside contours (pierce in the slug)
-        // and the EXTERIOR side for outside contours (pierce in the scrap):
-        // sweep_sign = -direction * orientation.
-        const int sweep_sign = static_cast<int>(-direction * orientation);
-
-        // 90 deg sweep, sized at the user's lead-in length.
-        auto arc_pts = geo::buildArcLead(
-          attach, tangent_dir, radius_abs, 90.0, sweep_sign, 16);
-
-        if (arc_pts.size() >= 2) {
-          // (1) Whole-arc side check: every arc vertex (except `attach`, a
-          // boundary point) must sit on the correct side of the contour,
-          // within slop. (2) Pierce headroom: the pierce must clear the
-          // nearest contour edge by >= radius_abs * 0.5 so the lead doesn't
-          // graze the opposite wall of a narrow pocket.
-          bool arc_ok = true;
-          for (size_t i = 0; i + 1 < arc_pts.size(); ++i) {
-            const bool inside = geo::pointIsInsidePolygon(contour, arc_pts[i]);
-            const bool wrong_side = is_inside ? !inside : inside;
-            if (wrong_side) {
-              const double edge_dist =
-                geo::pointToPolygonDistance(contour, arc_pts[i]);
-              if (edge_dist > side_slop) {
-                arc_ok = false;
-                break;
-              }
-            }
-          }
-          if (arc_ok) {
-            // Pierce headroom: the pierce (arc start) must clear the nearest
-            // contour edge by >= radius_abs * 0.5. pointToPolygonDistance
-            // returns the distance to the closest wall, so in a narrow pocket
-            // this is the OPPOSITE-wall distance -- rejecting here keeps the
-            // pierce from landing right against the far wall.
-            const double pierce_clearance =
-              geo::pointToPolygonDistance(contour, arc_pts.front());
-            if (pierce_clearance < radius_abs * 0.5)
-              arc_ok = false;
-          }
-          // Only commit the arc when it passed BOTH checks; otherwise leave
-          // arc_built false so we fall through to the straight lead-in.
-          if (arc_ok) {
-            // attach == contour[mid]; after rotating the contour to start at
-            // mid, the arc's snapped final vertex == rotated[0], so drop it.
-            attach_index = mid;
-            lead_in_pts.assign(arc_pts.begin(), arc_pts.end() - 1);
-            out->lead_in_is_arc = true;
-            arc_built = true;
-          }
+      if (edge_len <= 0.0)
+        return false;
+      const Point2d tangent_dir = { edx / edge_len, edy / edge_len };
+
+      // buildArcLead's sweep_sign chooses the side the arc curves toward.
+      // We want the INTERIOR side for inside contours (pierce in the slug)
+      // and the EXTERIOR side for outside contours (pierce in the scrap):
+      // sweep_sign = -direction * orientation.
+      const int sweep_sign = static_cast<int>(-direction * orientation);
+
+      // 90 deg sweep, sized at the user's lead-in length.
+      auto arc_pts = geo::buildArcLead(
+        attach, tangent_dir, radius_abs, 90.0, sweep_sign, 16);
+      if (arc_pts.size() < 2)
+        return false;
+
+      // (1) Whole-arc side check: every arc vertex (except `attach`, a
+      // boundary point) must sit on the correct side of the contour,
+      // within slop. (2) Pierce headroom: the pierce must clear the
+      // nearest contour edge by >= radius_abs * 0.5 so the lead doesn't
+      // graze the opposite wall of a narrow pocket.
+      for (size_t i = 0; i + 1 < arc_pts.size(); ++i) {
+        const bool inside = geo::pointIsInsidePolygon(contour, arc_pts[i]);
+        const bool wrong_side = is_inside ? !inside : inside;
+        if (wrong_side) {
+          const double edge_dist =
+            geo::pointToPolygonDistance(contour, arc_pts[i]);
+          if (edge_dist > side_slop)
+            return false;
         }
       }
+      // Pierce headroom: the pierce (arc start) must clear the nearest
+      // contour edge by >= radius_abs * 0.5. pointToPolygonDistance
+      // returns the distance to the closest wall, so in a narrow pocket
+      // this is the OPPOSITE-wall distance -- rejecting here keeps the
+      // pierce from landing right against the far wall.
+      const double pierce_clearance =
+        geo::pointToPolygonDistance(contour, arc_pts.front());
+      if (pierce_clearance < radius_abs * 0.5)
+        return false;
+
+      // Only commit the arc when it passed BOTH checks; otherwise the
+      // caller falls through to the straight lead-in. attach ==
+      // contour[mid]; after rotating the contour to start at mid, the arc's
+      // snapped final vertex == rotated[0], so drop it.
+      attach_index = mid;
+      lead_in_pts.assign(arc_pts.begin(), arc_pts.end() - 1);
+      out->lead_in_is_arc = true;
+      return true;
+    };
+
+    bool arc_built = false;
+    if (entry_hint) {
+      // Attach at the vertices nearest the hint first, where they sit on a
+      // straight run long enough to carry the arc
+      std::vector<size_t> near(contour.size());
+      std::iota(near.begin(), near.end(), 0);
+      const size_t tries = std::min<size_t>(near.size(), 16);
+      std::partial_sort(near.begin(),
+                        near.begin() + tries,
+                        near.end(),
+                        [&](size_t a, size_t b) {
+                          return geo::distance(contour[a], *entry_hint) <
+                                 geo::distance(contour[b], *entry_hint);
+                        });
+      for (size_t k = 0; k < tries && !arc_built; k++) {
+        geo::StraightRun run;
+        if (geo::straightRunThrough(
+              contour, near[k], min_segment_len, dev_tolerance, &run))
+          arc_built = try_arc(near[k]);
+      }
+    }
+
+    geo::StraightRun run;
+    if (!arc_built && geo::longestStraightRun(
+                        contour, min_segment_len, dev_tolerance, &run)) {
+      // Mid-run by vertex index
+      const size_t N = contour.size();
+      const size_t run_len_verts =
+        (run.end + N - run.start) % N; // 0 disallowed (chord_len>0)
+      arc_built = try_arc((run.start + run_len_verts / 2) % N);
     }
 
     if (!arc_built) {
       // ---- Fallback: straight lead-in ----
-      auto straight = findStraightPierce(contour, radius_abs, direction);
+      auto straight =
+        findStraightPierce(contour, radius_abs, direction, entry_hint);
       if (straight) {
         attach_index = straight->attach_index;
         lead_in_pts = { straight->pierce };
@@ -1146,6 +1398,15 @@ bool Part::createToolpathLeads(Toolpath*                   out,
       }
     }
   }
+  else if (entry_hint) {
+    // No lead-in: the cut starts on the contour, so start it at the vertex
+    // nearest the hint
+    for (size_t i = 1; i < contour.size(); i++) {
+      if (geo::distance(contour[i], *entry_hint) <
+          geo::distance(contour[attach_index], *entry_hint))
+        attach_index = i;
+    }
+  }
 
   // Rotate the contour so the attach vertex sits at index 0. With no lead-in
   // this is the identity (attach_index == 0).
@@ -1183,3 +1444,28 @@ bool Part::createToolpathLeads(Toolpath*                   out,
 
   return true;
 }
+
+bool Part::moveToolpathEntry(const Toolpath& tp,
+                             Point2d         entry_hint,
+                             Toolpath*       out)
+{
+  if (!tp.is_closed_contour ||
+      tp.points.size() < tp.lead_in_count + tp.lead_out_count + 3)
+    return false;
+
+  // The contour proper, from its start vertex to the last unique one
+  const std::vector<Point2d> contour(
+    tp.points.begin() + tp.lead_in_count,
+    tp.points.end() - tp.lead_out_count);
+  if (!createToolpathLeads(out,
+                           contour,
+                           tp.lead_in_length,
+                           tp.lead_out_length,
+                           tp.is_inside_contour ? -1 : +1,
+                           tp.smoothing,
+                           &entry_hint))
+    return false;
+  out->kerf_width = tp.kerf_width;
+  out->tag = tp.tag;
+  return true;
+}
@@ -4,29 +4,17 @@
 #include "../../geometry/geometry.h"
 #include "../Primitive.h"
 #include <NanoCut.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 class Part : public Primitive {
 public:
-  struct path_t {
-    std::vector<Point2d> points;
-    std::vector<Point2d> simplified_points; // Cached simplification result
-    std::vector<Point2d> built_points;
-    geo::Extents         bbox;              // Bounding box of built_points
-    bool                 is_closed;
-    bool                 is_inside_contour;
-    // Manual cut-direction override. By default toolpaths run in the
-    // plasma-quality direction (external profiles clockwise, holes
-    // counter-clockwise); this flag flips that default for a single path.
-    // Applied to the offset contour AFTER Clipper (Clipper canonicalizes input
-    // winding, so reversing the source points has no effect). Toggled from the
-    // CAM context menu.
-    bool                 reversed = false;
-    const Color4f*       color = &Primitive::s_default_color;
-  };
-
   // A built toolpath with explicit lead-in / lead-out metadata so the
   // gcode emitter knows where the contour proper starts and ends inside
   // `points`. contour_first = lead_in_count; contour_last =
@@ -42,6 +30,56 @@ public:
     // captured at build time so render() can draw the toolpath as a swath of
     // the actual cut width. 0 falls back to a thin centerline.
     double               kerf_width = 0.0;
+    // The lead request the leads were built from, so they can be rebuilt at
+    // another entry point (moveToolpathEntry)
+    double               lead_in_length = 0.0;
+    double               lead_out_length = 0.0;
+    double               smoothing = 0.0;
+    // Free for whoever collects toolpaths to note where each came from;
+    // kept when the leads are rebuilt
+    size_t               tag = 0;
+  };
+
+  // What a path's toolpaths depend on besides where the part sits
+  struct ToolpathKey {
+    double kerf = -1.0; // |toolpath_offset|; negative = nothing cached
+    double lead_in = 0.0;
+    double lead_out = 0.0;
+    double scale = 0.0;
+    float  smoothing = 0.0f;
+    bool   reversed = false;
+
+    bool operator==(const ToolpathKey&) const = default;
+  };
+
+  // Toolpaths (kerf offset, leads) and arrows of a path in part-local space:
+  // the simplified points scaled but not rotated or moved
+  struct LocalToolpaths {
+    ToolpathKey                       key; // What they were built for
+    std::vector<Toolpath>             toolpaths;
+    std::vector<std::vector<Point2d>> arrows;
+  };
+
+  struct path_t {
+    std::vector<Point2d> points;
+    // Cached simplification result. Like `local` below, it is replaced and
+    // never changed in place, so toolpath builds share it instead of copying.
+    std::shared_ptr<const std::vector<Point2d>> simplified_points;
+    std::vector<Point2d> built_points;
+    geo::Extents         bbox;              // Bounding box of built_points
+    bool                 is_closed;
+    bool                 is_inside_contour;
+    // Manual cut-direction override. By default toolpaths run in the
+    // plasma-quality direction (external profiles clockwise, holes
+    // counter-clockwise); this flag flips that default for a single path.
+    // Applied to the offset contour AFTER Clipper (Clipper canonicalizes input
+    // winding, so reversing the source points has no effect). Toggled from the
+    // CAM context menu.
+    bool                 reversed = false;
+    const Color4f*       color = &Primitive::s_default_color;
+    // Moving or rotating the part only transforms these while their key
+    // still matches
+    std::shared_ptr<const LocalToolpaths> local;
   };
 
   struct Layer {
@@ -67,6 +105,55 @@ public:
               smoothing == a.smoothing && angle == a.angle &&
               mouse_mode == a.mouse_mode);
     }
+    // Whether toolpaths built for `a` only need translating to match
+    bool sameShape(const part_control_data_t& a) const
+    {
+      return (lead_in_length == a.lead_in_length &&
+              lead_out_length == a.lead_out_length && scale == a.scale &&
+              smoothing == a.smoothing && angle == a.angle);
+    }
+  };
+
+  // A path as a build sees it: its flags and shared caches, its source
+  // points only when it has to be simplified again, and what the build
+  // makes of it
+  struct BuildPath {
+    std::vector<Point2d>                        points;
+    std::shared_ptr<const std::vector<Point2d>> simplified_points;
+    std::shared_ptr<const LocalToolpaths>       local;
+    bool                                        is_closed = false;
+    bool                                        is_inside_contour = false;
+    bool                                        reversed = false;
+    std::vector<Point2d>                        built_points;
+    geo::Extents                                bbox;
+  };
+  struct BuildLayer {
+    double                 toolpath_offset = 0.0;
+    bool                   toolpath_visible = false;
+    std::vector<BuildPath> paths;
+  };
+  // One toolpath build: the visible layers and control it was started with,
+  // and the built geometry once it finishes. Builds run on the background
+  // worker pool so the render thread never waits on RDP, Clipper or lead
+  // construction.
+  struct ToolpathBuild {
+    uint64_t                                    version = 0;
+    part_control_data_t                         control;
+    bool                                        resimplify = false;
+    std::unordered_map<std::string, BuildLayer> layers;
+    std::vector<Toolpath>                       tool_paths;
+    std::vector<std::vector<Point2d>>           arrows;
+    size_t                                      vertex_count = 0;
+    bool                                        failed = false;
+  };
+  // Shared between a part and its queued builds, which may outlive it.
+  // `version` is that of the latest submitted build; older builds see it
+  // change and give up.
+  struct BuildState {
+    std::mutex                     mutex;
+    std::condition_variable        done;
+    std::atomic<uint64_t>          version{ 0 };
+    std::unique_ptr<ToolpathBuild> result; // Latest finished, current build
   };
 
   std::unordered_map<std::string, Layer> m_layers;
@@ -100,6 +187,16 @@ public:
   Point2d                                m_bb_min{ 0.0, 0.0 };
   Point2d                                m_bb_max{ 0.0, 0.0 };
   size_t                                 m_number_of_verticies = 0;
+  std::shared_ptr<BuildState>            m_build =
+    std::make_shared<BuildState>();
+  // A build is queued or running; the previous toolpaths render dimmed
+  bool                                   m_build_pending = false;
+  bool                                   m_built = false; // Any build applied
+  // Smoothing that the cached simplified_points were made with
+  float                                  m_simplified_smoothing = -1.0f;
+  // Changes whenever m_tool_paths does and is never shared with another
+  // part, so whatever is derived from the toolpaths can be cached against it
+  uint64_t                               m_toolpaths_stamp = 0;
 
   Part(std::string_view name, std::unordered_map<std::string, Layer>&& layers)
     : m_layers(std::move(layers)), m_part_name(name)
@@ -126,19 +223,22 @@ public:
   nlohmann::json serialize() override;
 
   // Part-specific methods
-  std::vector<std::vector<Point2d>> offsetPath(std::vector<Point2d> path,
-                                               double               offset);
+  // Blocks until the toolpaths match the current control (e.g. before
+  // emitting G-code)
+  void finishToolpaths();
+  static std::vector<std::vector<Point2d>>
+       offsetPath(std::vector<Point2d> path, double offset);
   void getBoundingBox(Point2d* bbox_min, Point2d* bbox_max);
   bool checkIfPointIsInsidePath(std::vector<Point2d> path, Point2d point);
   bool checkIfPathIsInsidePath(std::vector<Point2d> path1,
                                std::vector<Point2d> path2);
   std::vector<Toolpath>             getOrderedToolpaths();
-  double                            perpendicularDistance(const Point2d& pt,
-                                                          const Point2d& lineStart,
-                                                          const Point2d& lineEnd);
-  void simplify(const std::vector<Point2d>& pointList,
-                std::vector<Point2d>&       out,
-                double                      epsilon);
+  static double perpendicularDistance(const Point2d& pt,
+                                      const Point2d& lineStart,
+                                      const Point2d& lineEnd);
+  static void   simplify(const std::vector<Point2d>& pointList,
+                         std::vector<Point2d>&       out,
+                         double                      epsilon);
   Point2d*
   getClosestPoint(size_t* index, Point2d point, std::vector<Point2d>* points);
   // Builds a toolpath (lead-in + contour, optionally lead-out) into
@@ -148,13 +248,42 @@ public:
   // contours only -- inside contours rely on overburn in the emitter and
   // never get a lead-out. Both the lead-in and the lead-out try an arc
   // first and fall back to a straight lead when geometry doesn't support
-  // arc tangency.
-  bool createToolpathLeads(Toolpath*                   out,
-                           const std::vector<Point2d>& contour,
-                           double                      lead_in_len,
-                           double                      lead_out_len,
-                           int                         direction
-                           );
+  // arc tangency. `smoothing` is the RDP tolerance the contour was
+  // simplified with, which widens the side checks. With an `entry_hint`,
+  // leads attach as near it as the same checks allow.
+  static bool createToolpathLeads(Toolpath*                   out,
+                                  const std::vector<Point2d>& contour,
+                                  double                      lead_in_len,
+                                  double                      lead_out_len,
+                                  int                         direction,
+                                  double                      smoothing,
+                                  const Point2d*              entry_hint);
+  // Rebuilds the leads of closed toolpath `tp` into `out` with its entry
+  // moved as near `entry_hint` as the lead rules allow. False if `tp` is
+  // open or its contour too small to lead.
+  static bool moveToolpathEntry(const Toolpath& tp,
+                                Point2d         entry_hint,
+                                Toolpath*       out);
+
+private:
+  // Acts on a control change: translates the toolpaths if the part only
+  // moved, else submits a build; adopts a finished build
+  void syncToolpaths();
+  // Starts a build for the current control and layers, superseding any
+  // build still queued or running
+  void submitToolpathBuild();
+  // Adopts the finished build, if any; with `wait`, blocks until the latest
+  // submitted one finishes
+  void collectToolpathBuild(bool wait);
+  // Moves the built geometry of visible layers by (dx, dy)
+  void translateBuilt(double dx, double dy);
+  // Worker side: fills in `build`; false if it was superseded meanwhile
+  static bool buildToolpaths(ToolpathBuild& build, const BuildState& state);
+  // Offsets `path` by the kerf of `key` and adds leads, in part-local space
+  static std::shared_ptr<const LocalToolpaths>
+  buildLocalToolpaths(const BuildPath&           path,
+                      const ToolpathKey&         key,
+                      const part_control_data_t& control);
 };
 
 #endif // PATH_